@@ -0,0 +1,176 @@
+#ifndef ASYNC_JOB_H
+#define ASYNC_JOB_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "thread_pool.h"
+
+namespace async
+{
+    enum class jobStatus_e : uint8_t
+    {
+        PENDING,
+        DONE,
+        CANCELLED,
+        FAILED
+    };
+
+    static inline auto jobStatusToString(jobStatus_e js) noexcept -> std::string_view
+    {
+        switch (js)
+        {
+        case jobStatus_e::PENDING:
+            return "PENDING";
+        case jobStatus_e::DONE:
+            return "DONE";
+        case jobStatus_e::CANCELLED:
+            return "CANCELLED";
+        case jobStatus_e::FAILED:
+            return "FAILED";
+        }
+    }
+
+    /**
+     * @brief Thrown out of a checkpoint when somebody asked the job to stop
+     */
+    struct jobCancelled_t : std::exception
+    {
+        auto what() const noexcept -> const char * override { return "job cancelled"; }
+    };
+
+    /**
+     * @brief Everything the outside world can see about a running job
+     *
+     *        Shared between whoever submitted the job (to poll / cancel it) and the job itself (to report progress)
+     */
+    class jobState_t
+    {
+    public:
+        jobState_t(std::string description)
+            : m_description(std::move(description)) {}
+
+        auto description() const noexcept -> const std::string & { return m_description; }
+        auto progress() const noexcept -> double { return m_progress.load(std::memory_order_relaxed); }
+        auto status() const noexcept -> jobStatus_e { return m_status.load(std::memory_order_acquire); }
+        auto isFinished() const noexcept -> bool { return status() != jobStatus_e::PENDING; }
+
+        /**
+         * @brief Cooperative, the job only notices at its next checkpoint
+         */
+        auto requestCancel() noexcept -> void { m_cancelRequested.store(true, std::memory_order_relaxed); }
+        auto isCancelRequested() const noexcept -> bool { return m_cancelRequested.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Blocks the calling thread until the job is no longer pending
+         */
+        auto wait() const noexcept -> void { m_status.wait(jobStatus_e::PENDING, std::memory_order_acquire); }
+
+        auto setProgress(double progress) noexcept -> void { m_progress.store(progress, std::memory_order_relaxed); }
+
+        /**
+         * @brief Record progress, then give the pool a chance to run something else before continuing
+         *
+         *        Throws jobCancelled_t out of the co_await if the job was asked to stop
+         */
+        auto checkpoint(threadPool_t &pool, double progress) noexcept
+        {
+            struct checkpointAwaiter_t
+            {
+                jobState_t &state;
+                threadPool_t &pool;
+
+                auto await_ready() const noexcept -> bool { return state.isCancelRequested(); }
+                auto await_suspend(std::coroutine_handle<> h) -> void { pool.post(h); }
+                auto await_resume() const -> void
+                {
+                    if (state.isCancelRequested())
+                        throw jobCancelled_t();
+                }
+            };
+
+            setProgress(progress);
+            return checkpointAwaiter_t{*this, pool};
+        }
+
+        auto finish(jobStatus_e js) noexcept -> void
+        {
+            if (js == jobStatus_e::DONE)
+                setProgress(1.0);
+
+            m_status.store(js, std::memory_order_release);
+            m_status.notify_all();
+        }
+
+    private:
+        std::string m_description;
+        std::atomic<double> m_progress = 0.0; // [0, 1]
+        std::atomic<jobStatus_e> m_status = jobStatus_e::PENDING;
+        std::atomic<bool> m_cancelRequested = false;
+    };
+
+    using jobHandle_t = std::shared_ptr<jobState_t>;
+
+    /**
+     * @brief Return type of a fire-and-forget coroutine that reports through a jobState_t
+     *
+     *        The first parameter of the coroutine MUST be the jobHandle_t it reports to. The coroutine starts
+     *        running on the caller's thread, so the first thing it should do is co_await pool.schedule()
+     *
+     *  NOTE: The coroutine frame cleans itself up once it finishes, job_t only hands back the shared state
+     */
+    class job_t
+    {
+    public:
+        struct promise_type
+        {
+            template <typename... Args>
+            promise_type(const jobHandle_t &handle, Args &&...)
+                : state(handle) {}
+
+            ~promise_type()
+            {
+                // Destroyed without ever finishing (i.e. the pool shut down before getting to us)
+                if (!state->isFinished())
+                    state->finish(jobStatus_e::CANCELLED);
+            }
+
+            auto get_return_object() -> job_t { return job_t(state); }
+            auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+            auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+            auto return_void() -> void { state->finish(jobStatus_e::DONE); }
+
+            auto unhandled_exception() noexcept -> void
+            {
+                try
+                {
+                    std::rethrow_exception(std::current_exception());
+                }
+                catch (const jobCancelled_t &)
+                {
+                    state->finish(jobStatus_e::CANCELLED);
+                }
+                catch (...)
+                {
+                    state->finish(jobStatus_e::FAILED);
+                }
+            }
+
+            jobHandle_t state;
+        };
+
+        auto state() const noexcept -> const jobHandle_t & { return m_state; }
+
+    private:
+        explicit job_t(jobHandle_t state)
+            : m_state(std::move(state)) {}
+
+        jobHandle_t m_state;
+    };
+}
+
+#endif // ASYNC_JOB_H
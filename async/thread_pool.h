@@ -0,0 +1,127 @@
+#ifndef ASYNC_THREAD_POOL_H
+#define ASYNC_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace async
+{
+    /**
+     * @brief Fixed set of worker threads that resume coroutines handed to it
+     *
+     *        Coroutines get onto the pool by co_await-ing schedule(), everything after that point runs on a worker
+     */
+    class threadPool_t
+    {
+    public:
+        explicit threadPool_t(std::size_t numThreads = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            m_workers.reserve(numThreads);
+            for (std::size_t i = 0; i < numThreads; ++i)
+                m_workers.emplace_back([this]
+                                       { workerLoop(); });
+        }
+
+        ~threadPool_t()
+        {
+            shutdown();
+        }
+
+        /**
+         * @brief Awaiting this suspends the current coroutine and resumes it on one of the workers
+         */
+        auto schedule() noexcept
+        {
+            struct scheduleAwaiter_t
+            {
+                threadPool_t &pool;
+
+                auto await_ready() const noexcept -> bool { return false; }
+                auto await_suspend(std::coroutine_handle<> h) -> void { pool.post(h); }
+                auto await_resume() const noexcept -> void {}
+            };
+
+            return scheduleAwaiter_t{*this};
+        }
+
+        auto post(std::coroutine_handle<> h) -> void
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_queue.push_back(h);
+            }
+            m_cv.notify_one();
+        }
+
+        /**
+         * @brief Stop the workers once they've finished what they're running
+         *
+         *  NOTE: Anything still waiting in the queue is destroyed without ever being resumed
+         */
+        auto shutdown() -> void
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_stopping)
+                    return;
+
+                m_stopping = true;
+            }
+            m_cv.notify_all();
+
+            for (auto &worker : m_workers)
+                worker.join();
+
+            for (auto h : m_queue)
+                h.destroy();
+
+            m_queue.clear();
+        }
+
+        auto numThreads() const noexcept -> std::size_t { return m_workers.size(); }
+
+    private:
+        // Prevent copying
+        threadPool_t(const threadPool_t &) = delete;
+        threadPool_t &operator=(const threadPool_t &) = delete;
+
+        // Prevent moving
+        threadPool_t(threadPool_t &&) = delete;
+        threadPool_t &operator=(threadPool_t &&) = delete;
+
+        auto workerLoop() -> void
+        {
+            while (true)
+            {
+                std::coroutine_handle<> h;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_cv.wait(lock, [this]
+                              { return m_stopping || !m_queue.empty(); });
+
+                    if (m_stopping)
+                        return;
+
+                    h = m_queue.front();
+                    m_queue.pop_front();
+                }
+
+                h.resume();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::coroutine_handle<>> m_queue; // Coroutines ready to be resumed, FIFO
+        bool m_stopping = false;
+
+        std::vector<std::thread> m_workers;
+    };
+}
+
+#endif // ASYNC_THREAD_POOL_H
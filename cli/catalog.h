@@ -0,0 +1,56 @@
+#ifndef CLI_CATALOG_H
+#define CLI_CATALOG_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "table/table.h"
+
+/**
+ * @brief All the tables the CLI knows about, by name
+ *
+ *        Tables are handed out as immutable snapshots. Background jobs work on their own copy
+ *        and publish the finished table back, replacing whatever was there before
+ */
+class catalog_t
+{
+public:
+    using tablePtr_t = std::shared_ptr<const table::table_t>;
+
+    auto publish(const std::string &name, tablePtr_t t) -> void
+    {
+        std::lock_guard lock(m_mutex);
+        m_tables[name] = std::move(t);
+    }
+
+    auto find(const std::string &name) const -> tablePtr_t
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_tables.find(name);
+        if (it == m_tables.end())
+            return nullptr;
+
+        return it->second;
+    }
+
+    auto listNames() const -> std::vector<std::string>
+    {
+        std::lock_guard lock(m_mutex);
+
+        std::vector<std::string> names;
+        names.reserve(m_tables.size());
+        for (const auto &[name, _] : m_tables)
+            names.push_back(name);
+
+        return names;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, tablePtr_t> m_tables;
+};
+
+#endif // CLI_CATALOG_H
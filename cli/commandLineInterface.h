@@ -5,14 +5,22 @@
 #include <string_view>
 #include <optional>
 #include <memory>
+#include <vector>
 
 #include "actions/actions.h"
+#include "catalog.h"
+#include "jobs.h"
 
 class commandLineInterface_t
 {
 public:
     commandLineInterface_t(){};
 
+    ~commandLineInterface_t()
+    {
+        stopJobs();
+    }
+
     auto run() -> void
     {
         clearTerminal();
@@ -20,7 +28,7 @@ public:
 
         while (true)
         {
-            auto responseNum = askForNumberedResponse("What action would you like to take:", possibleActions);
+            auto responseNum = askForNumberedResponse("What action would you like to take:", actionOptions());
             auto &actionToTake = possibleActions[responseNum];
 
             submitTask(actionToTake->taskType());
@@ -36,19 +44,196 @@ private:
     commandLineInterface_t(commandLineInterface_t &&) = delete;
     commandLineInterface_t &operator=(commandLineInterface_t &&) = delete;
 
+    /**
+     * @brief Anything that could take a while is handed off to the thread pool as a job
+     *        so we can get straight back to asking the user what to do next
+     */
     auto submitTask(task_e t) -> void
     {
         switch (t)
         {
         case task_e::SHUT_DOWN:
-            std::terminate();
+            shutDown();
         case task_e::MAKE_TABLE:
-            return;
+            return makeTable();
         case task_e::SHOW_TABLE:
-            return;
+            return showTable();
         case task_e::LIST_TABLES:
+            return listTables();
+        case task_e::SORT_TABLE:
+            return sortTable();
+        case task_e::LIST_JOBS:
+            return listJobs();
+        case task_e::CANCEL_JOB:
+            return cancelJob();
+        }
+    }
+
+    [[noreturn]] auto shutDown() -> void
+    {
+        stopJobs();
+        std::exit(0);
+    }
+
+    /**
+     * @brief Cancel every job and wait for them to finish, jobs hold on to the catalog until they do
+     */
+    auto stopJobs() -> void
+    {
+        for (const auto &job : m_jobs)
+            job->requestCancel();
+
+        for (const auto &job : m_jobs)
+            job->wait();
+
+        m_pool.shutdown();
+    }
+
+    auto makeTable() -> void
+    {
+        static const std::vector<std::size_t> sizes = {1'000, 100'000, 1'000'000, 10'000'000};
+
+        std::vector<std::string> options;
+        for (const auto size : sizes)
+            options.push_back(std::to_string(size) + " random rows");
+
+        auto numRows = sizes[askForNumberedResponse("How big should the table be:", options)];
+        auto name = "table_" + std::to_string(m_nextTableId++);
+
+        launch("Load " + std::to_string(numRows) + " rows into " + name, jobs::loadRandomTable, m_catalog, name, numRows);
+    }
+
+    auto showTable() -> void
+    {
+        auto maybeName = askForTableName();
+        if (maybeName.has_value() == false)
             return;
+
+        static constexpr std::size_t maxRowsShown = 20;
+
+        auto t = m_catalog.find(maybeName.value());
+        table::printTableDef(t->getTableDef());
+
+        const auto &rows = t->getRows();
+        for (std::size_t i = 0; i < std::min(rows.size(), maxRowsShown); ++i)
+            table::printRow(rows[i]);
+
+        if (rows.size() > maxRowsShown)
+            std::cout << "... (" << rows.size() - maxRowsShown << " more rows)\n";
+
+        std::cout << '\n';
+    }
+
+    auto listTables() -> void
+    {
+        for (const auto &name : m_catalog.listNames())
+        {
+            auto t = m_catalog.find(name);
+            std::cout << name << " (" << t->getRows().size() << " rows): ";
+            table::printTableDef(t->getTableDef());
         }
+
+        std::cout << '\n';
+    }
+
+    auto sortTable() -> void
+    {
+        auto maybeName = askForTableName();
+        if (maybeName.has_value() == false)
+            return;
+
+        const auto &name = maybeName.value();
+        auto t = m_catalog.find(name);
+        const auto &tableDef = t->getTableDef();
+
+        std::vector<std::string> columns;
+        for (std::size_t i = 0; i < tableDef.size(); ++i)
+            columns.push_back(std::to_string(i) + " (" + std::string(table::colTypeToString(tableDef[i])) + ")");
+
+        auto colIndex = askForNumberedResponse("Which column should we sort on:", columns);
+        auto sortOrder = askForNumberedResponse("Which order:", std::vector<std::string>{"ASC", "DESC"}) == 0
+                             ? table::sortOrder_e::ASC
+                             : table::sortOrder_e::DESC;
+
+        std::vector<table::sortPolicy_t> sortPolicies = {{table::colIndex_t(colIndex), sortOrder}};
+        launch("Sort " + name + " on column " + std::to_string(colIndex), jobs::sortTable, m_catalog, name, std::move(sortPolicies));
+    }
+
+    auto listJobs() -> void
+    {
+        if (m_jobs.empty())
+            std::cout << "No jobs have been submitted\n";
+
+        for (std::size_t i = 0; i < m_jobs.size(); ++i)
+        {
+            const auto &job = m_jobs[i];
+            std::cout << (i + 1) << ": " << job->description() << " - "
+                      << async::jobStatusToString(job->status()) << " "
+                      << static_cast<int>(job->progress() * 100) << "%\n";
+        }
+
+        std::cout << '\n';
+    }
+
+    auto cancelJob() -> void
+    {
+        std::vector<async::jobHandle_t> pending;
+        std::vector<std::string> options;
+        for (const auto &job : m_jobs)
+        {
+            if (job->isFinished())
+                continue;
+
+            pending.push_back(job);
+            options.push_back(job->description());
+        }
+
+        if (pending.empty())
+        {
+            std::cout << "There are no running jobs\n\n";
+            return;
+        }
+
+        pending[askForNumberedResponse("Which job should be cancelled:", options)]->requestCancel();
+    }
+
+    /**
+     * @brief Start a job coroutine, it keeps running in the pool after we return
+     */
+    template <typename F, typename... Args>
+    auto launch(std::string description, F &&jobFunc, Args &&...args) -> void
+    {
+        auto job = std::make_shared<async::jobState_t>(std::move(description));
+        m_jobs.push_back(job);
+
+        std::forward<F>(jobFunc)(std::move(job), m_pool, std::forward<Args>(args)...);
+        std::cout << "Started: " << m_jobs.back()->description() << "\n\n";
+    }
+
+    auto askForTableName() -> std::optional<std::string>
+    {
+        auto names = m_catalog.listNames();
+        if (names.empty())
+        {
+            std::cout << "There are no tables yet, make one first\n\n";
+            return std::nullopt;
+        }
+
+        return names[askForNumberedResponse("Which table:", names)];
+    }
+
+    static auto actionOptions() -> const std::vector<std::string> &
+    {
+        static const auto options = []
+        {
+            std::vector<std::string> ret;
+            for (const auto &action : possibleActions)
+                ret.push_back(action->userOption());
+
+            return ret;
+        }();
+
+        return options;
     }
 
     auto clearTerminal() -> void
@@ -62,7 +247,7 @@ private:
                   << '\n';
     }
 
-    auto askForNumberedResponse(const std::string_view &question, const possibleActions_t &options) -> size_t
+    auto askForNumberedResponse(const std::string_view &question, const std::vector<std::string> &options) -> size_t
     {
         while (true)
         {
@@ -73,7 +258,7 @@ private:
             for (auto i = 0; i < options.size(); ++i)
             {
                 auto &currOption = options[i];
-                std::cout << (i + 1) << ": " << currOption->userOption() << '\n';
+                std::cout << (i + 1) << ": " << currOption << '\n';
             }
 
             std::cout << '\n';
@@ -85,7 +270,7 @@ private:
             }
 
             clearTerminal();
-            std::cout << "You chose: " << options[maybeValidNumber.value()]->userOption() << "\n\n";
+            std::cout << "You chose: " << options[maybeValidNumber.value()] << "\n\n";
             return maybeValidNumber.value();
         }
 
@@ -133,6 +318,13 @@ private:
             return std::nullopt;
         }
     }
+
+    catalog_t m_catalog;
+    std::vector<async::jobHandle_t> m_jobs; // Every job ever submitted, in order, so they can be polled
+    std::size_t m_nextTableId = 0;
+
+    // Declared last so it's torn down first, its workers may be running jobs that use everything above
+    async::threadPool_t m_pool;
 };
 
 #endif // CLI_COMMAND_LINE_INTERFACE_H
\ No newline at end of file
@@ -4,7 +4,10 @@ actions: List[Tuple[str, str]] = [
     ("shut_down", "Shut down the system gracefully"),
     ("make_table", "Make a table"),
     ("show_table", "Show an existing table"),
-    ("list_tables", "List all existing tables")
+    ("list_tables", "List all existing tables"),
+    ("sort_table", "Sort an existing table in the background"),
+    ("list_jobs", "List background jobs and their progress"),
+    ("cancel_job", "Cancel a background job")
 ]
 
 def to_camel_case(snake_str):
@@ -0,0 +1,87 @@
+#ifndef CLI_JOBS_H
+#define CLI_JOBS_H
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "async/job.h"
+#include "catalog.h"
+
+/**
+ * @brief Background work the CLI can kick off. Each one reports through its jobHandle_t
+ *        and only touches the catalog once it has a finished table to hand back
+ */
+namespace jobs
+{
+    using namespace table;
+
+    static constexpr std::size_t rowsPerCheckpoint = 1 << 16;
+
+    /**
+     * @brief Fill a brand new table with random rows
+     */
+    static inline auto loadRandomTable(async::jobHandle_t job,
+                                       async::threadPool_t &pool,
+                                       catalog_t &catalog,
+                                       std::string name,
+                                       std::size_t numRows) -> async::job_t
+    {
+        co_await pool.schedule();
+
+        auto t = std::make_shared<table_t>(std::vector<colType_e>{colType_e::STRING, colType_e::INTEGER, colType_e::BOOLEAN,
+                                                                   colType_e::DOUBLE, colType_e::COLOR});
+
+        std::mt19937 gen(numRows);
+        std::uniform_int_distribution<int> intDist(0, 1'000'000);
+        std::uniform_real_distribution<double> doubleDist(0.0, 1.0);
+        std::uniform_int_distribution<int> colorDist(0, 2);
+
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            if (i % rowsPerCheckpoint == 0)
+                co_await job->checkpoint(pool, static_cast<double>(i) / numRows);
+
+            t->appendRow({std::to_string(intDist(gen) % 1000),
+                          intDist(gen),
+                          intDist(gen) % 2 == 0,
+                          doubleDist(gen),
+                          static_cast<color_e>(colorDist(gen))});
+        }
+
+        catalog.publish(name, std::move(t));
+    }
+
+    /**
+     * @brief Sort a copy of a table and publish it under the same name
+     *
+     *  NOTE: Anything published under that name while we were sorting gets overwritten
+     */
+    static inline auto sortTable(async::jobHandle_t job,
+                                 async::threadPool_t &pool,
+                                 catalog_t &catalog,
+                                 std::string name,
+                                 std::vector<sortPolicy_t> sortPolicies) -> async::job_t
+    {
+        co_await pool.schedule();
+
+        auto snapshot = catalog.find(name);
+        if (snapshot == nullptr)
+            throw std::runtime_error("No table named " + name);
+
+        auto t = std::make_shared<table_t>(*snapshot);
+        snapshot.reset();
+
+        static constexpr std::size_t numChunks = 64;
+        t->sort(sortPolicies, numChunks, [&job](double progress)
+                {
+                    job->setProgress(progress);
+                    if (job->isCancelRequested())
+                        throw async::jobCancelled_t(); });
+
+        co_await job->checkpoint(pool, 1.0);
+        catalog.publish(name, std::move(t));
+    }
+}
+
+#endif // CLI_JOBS_H
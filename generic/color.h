@@ -23,6 +23,8 @@ class Color
 public:
     Color(color_e _c) : c(_c) {}
 
+    auto get() const -> color_e { return c; }
+
     friend auto operator<=>(const Color &l, const Color &r)
     {
         return static_cast<uint8_t>(l.c) <=> static_cast<uint8_t>(r.c);
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+
+#include <sys/resource.h>
+
+#include "table/durable_table.h"
+
+// Curiously, GTEST isn't smart enough to use <=>
+auto operator==(const Color &l, const Color &r) -> bool
+{
+    std::weak_ordering cmp = l <=> r;
+    return cmp == std::weak_ordering::equivalent;
+}
+
+namespace test
+{
+    using namespace table;
+
+    static const std::vector<colType_e> tableDef = {colType_e::STRING, colType_e::INTEGER, colType_e::BOOLEAN,
+                                                    colType_e::DOUBLE, colType_e::COLOR};
+
+    auto makeRow(int i) -> row_t
+    {
+        return {std::string(i % 5, 'x'), i, i % 2 == 0, i * 0.25, static_cast<color_e>(i % 3)};
+    }
+
+    auto freshPath(const std::string &name) -> std::string
+    {
+        auto path = ::testing::TempDir() + name;
+        std::filesystem::remove(path + ".wal");
+        std::filesystem::remove(path + ".checkpoint");
+        return path;
+    }
+
+    auto expectRows(const table_t &t, int numRows) -> void
+    {
+        ASSERT_EQ(t.getRows().size(), numRows);
+        for (auto i = 0; i < numRows; ++i)
+            EXPECT_EQ(t.getRows()[i], makeRow(i));
+    }
+
+    TEST(durableTableTest, replaysLog)
+    {
+        auto path = freshPath("replaysLog");
+        {
+            durableTable_t t(path, tableDef, durability_e::ASYNC);
+            for (auto i = 0; i < 1000; ++i)
+                t.appendRow(makeRow(i));
+        }
+
+        durableTable_t reopened(path, tableDef);
+        expectRows(reopened.getTable(), 1000);
+    }
+
+    TEST(durableTableTest, syncAppendsFromManyThreads)
+    {
+        auto path = freshPath("syncAppends");
+        {
+            durableTable_t t(path, tableDef, durability_e::SYNC);
+
+            std::vector<std::thread> threads;
+            for (auto thread = 0; thread < 4; ++thread)
+                threads.emplace_back([&t]
+                                     {
+                                         for (auto i = 0; i < 50; ++i)
+                                             t.appendRow(makeRow(i)); });
+
+            for (auto &thread : threads)
+                thread.join();
+        }
+
+        durableTable_t reopened(path, tableDef);
+        EXPECT_EQ(reopened.getTable().getRows().size(), 200);
+    }
+
+    TEST(durableTableTest, checkpointTruncatesLog)
+    {
+        auto path = freshPath("checkpoint");
+        {
+            durableTable_t t(path, tableDef, durability_e::ASYNC);
+            for (auto i = 0; i < 100; ++i)
+                t.appendRow(makeRow(i));
+
+            t.checkpoint();
+            auto logSize = std::filesystem::file_size(path + ".wal");
+
+            for (auto i = 100; i < 150; ++i)
+                t.appendRow(makeRow(i));
+
+            t.flush();
+            EXPECT_GT(std::filesystem::file_size(path + ".wal"), logSize);
+        }
+
+        durableTable_t reopened(path, tableDef);
+        expectRows(reopened.getTable(), 150);
+    }
+
+    TEST(durableTableTest, ignoresTornWrite)
+    {
+        auto path = freshPath("tornWrite");
+        {
+            durableTable_t t(path, tableDef, durability_e::ASYNC);
+            for (auto i = 0; i < 10; ++i)
+                t.appendRow(makeRow(i));
+        }
+
+        // A full record header promising a 64 byte payload, followed by only part of that payload
+        {
+            const char buf[] = "\x40\x00\x00\x00"                 // payloadSize
+                               "\x00\x00\x00\x00"                 // checksum
+                               "\x0b\x00\x00\x00\x00\x00\x00\x00" // lsn
+                               "garbage";
+
+            std::ofstream log(path + ".wal", std::ios::binary | std::ios::app);
+            log.write(buf, sizeof(buf) - 1);
+        }
+
+        {
+            durableTable_t reopened(path, tableDef);
+            expectRows(reopened.getTable(), 10);
+            reopened.appendRow(makeRow(10));
+        }
+
+        durableTable_t reopened(path, tableDef);
+        expectRows(reopened.getTable(), 11);
+    }
+
+    TEST(durableTableTest, ignoresCorruptRecord)
+    {
+        auto path = freshPath("corruptRecord");
+        {
+            durableTable_t t(path, tableDef, durability_e::ASYNC);
+            for (auto i = 0; i < 10; ++i)
+                t.appendRow(makeRow(i));
+        }
+
+        // Every byte of the last record made it to disk, but one of them isn't what was written
+        {
+            std::fstream log(path + ".wal", std::ios::binary | std::ios::in | std::ios::out);
+            log.seekg(-1, std::ios::end);
+            const auto last = static_cast<char>(log.get());
+            log.seekp(-1, std::ios::end);
+            log.put(static_cast<char>(last ^ 0x5a));
+        }
+
+        {
+            durableTable_t reopened(path, tableDef);
+            expectRows(reopened.getTable(), 9);
+            reopened.appendRow(makeRow(9));
+        }
+
+        durableTable_t reopened(path, tableDef);
+        expectRows(reopened.getTable(), 10);
+    }
+
+    TEST(durableTableTest, recoversFromTornHeader)
+    {
+        // Crashing right after the log was created leaves it empty, or with only part of its header
+        for (const auto headerBytes : {0, 5, 12})
+        {
+            auto path = freshPath("tornHeader");
+            {
+                durableTable_t t(path, tableDef, durability_e::ASYNC);
+            }
+            std::filesystem::resize_file(path + ".wal", headerBytes);
+
+            {
+                durableTable_t reopened(path, tableDef);
+                expectRows(reopened.getTable(), 0);
+                reopened.appendRow(makeRow(0));
+            }
+
+            durableTable_t reopened(path, tableDef);
+            expectRows(reopened.getTable(), 1);
+        }
+    }
+
+    TEST(durableTableTest, refusesAppendsAfterWriteFailure)
+    {
+        auto path = freshPath("writeFailure");
+        durableTable_t t(path, tableDef, durability_e::SYNC);
+        t.appendRow(makeRow(0));
+
+        // Don't let the log grow any more, so the next write to it fails with EFBIG instead of killing us
+        const auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit oldLimit;
+        ::getrlimit(RLIMIT_FSIZE, &oldLimit);
+        rlimit limit = oldLimit;
+        limit.rlim_cur = std::filesystem::file_size(path + ".wal");
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+
+        EXPECT_THROW(t.appendRow(makeRow(1)), std::system_error);
+        EXPECT_THROW(t.appendRow(makeRow(2)), std::system_error);
+
+        ::setrlimit(RLIMIT_FSIZE, &oldLimit);
+        std::signal(SIGXFSZ, oldHandler);
+
+        // Even with room to grow again, a failed log never writes anything more
+        EXPECT_THROW(t.flush(), std::system_error);
+        EXPECT_EQ(std::filesystem::file_size(path + ".wal"), limit.rlim_cur);
+
+        // The row whose write failed made it into the table, the one after it didn't
+        EXPECT_EQ(t.getTable().getRows().size(), 2);
+    }
+
+    TEST(durableTableTest, rejectsDifferentTableDef)
+    {
+        auto path = freshPath("differentTableDef");
+        {
+            durableTable_t t(path, {colType_e::INTEGER}, durability_e::ASYNC);
+            t.appendRow({1});
+            t.appendRow({2});
+        }
+
+        EXPECT_THROW(durableTable_t(path, {colType_e::STRING, colType_e::INTEGER}), std::runtime_error);
+
+        // Same goes for the checkpoint, once the log has been emptied into it
+        {
+            durableTable_t t(path, {colType_e::INTEGER});
+            t.checkpoint();
+        }
+
+        EXPECT_THROW(durableTable_t(path, {colType_e::STRING, colType_e::INTEGER}), std::runtime_error);
+
+        // Nothing was thrown away along the way
+        durableTable_t reopened(path, {colType_e::INTEGER});
+        EXPECT_EQ(reopened.getTable().getRows(), (rows_t{{1}, {2}}));
+    }
+};
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "async/job.h"
+
+namespace test
+{
+    using namespace async;
+
+    auto countTo(jobHandle_t job, threadPool_t &pool, int target, std::atomic<int> &counter) -> job_t
+    {
+        co_await pool.schedule();
+
+        for (auto i = 0; i < target; ++i)
+        {
+            co_await job->checkpoint(pool, static_cast<double>(i) / target);
+            ++counter;
+        }
+    }
+
+    auto failImmediately(jobHandle_t job, threadPool_t &pool) -> job_t
+    {
+        co_await pool.schedule();
+        throw std::runtime_error("oops");
+    }
+
+    TEST(jobTest, runsToCompletion)
+    {
+        threadPool_t pool(2);
+        std::atomic<int> counter = 0;
+
+        auto job = countTo(std::make_shared<jobState_t>("count"), pool, 1000, counter).state();
+        job->wait();
+
+        EXPECT_EQ(job->status(), jobStatus_e::DONE);
+        EXPECT_EQ(job->progress(), 1.0);
+        EXPECT_EQ(counter, 1000);
+    }
+
+    TEST(jobTest, cancelStopsAtCheckpoint)
+    {
+        threadPool_t pool(1);
+        std::atomic<int> counter = 0;
+
+        auto state = std::make_shared<jobState_t>("count");
+        state->requestCancel();
+
+        auto job = countTo(state, pool, 1000, counter).state();
+        job->wait();
+
+        EXPECT_EQ(job->status(), jobStatus_e::CANCELLED);
+        EXPECT_EQ(counter, 0);
+    }
+
+    TEST(jobTest, exceptionMarksFailed)
+    {
+        threadPool_t pool(1);
+
+        auto job = failImmediately(std::make_shared<jobState_t>("fail"), pool).state();
+        job->wait();
+
+        EXPECT_EQ(job->status(), jobStatus_e::FAILED);
+    }
+};
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "table/partitioned_table.h"
+
+// Curiously, GTEST isn't smart enough to use <=>
+auto operator==(const Color &l, const Color &r) -> bool
+{
+    std::weak_ordering cmp = l <=> r;
+    return cmp == std::weak_ordering::equivalent;
+}
+
+namespace test
+{
+    using namespace table;
+
+    static const std::vector<colType_e> tableDef = {colType_e::INTEGER, colType_e::STRING, colType_e::DOUBLE};
+
+    auto makeRow(int i) -> row_t
+    {
+        return {(i * 7919) % 1000, std::to_string(i % 17), i * 0.5};
+    }
+
+    /**
+     * @brief Same rows appended to a partitioned table and to a plain one to check against
+     */
+    auto setUpTables(partitionedTable_t &partitioned, table_t &expected, int numRows) -> void
+    {
+        for (auto i = 0; i < numRows; ++i)
+        {
+            partitioned.appendRow(makeRow(i));
+            expected.appendRow(makeRow(i));
+        }
+    }
+
+    TEST(partitionedTableTest, hashSortMerges)
+    {
+        partitionedTable_t partitioned(tableDef, partitionSpec_t::hash(colIndex_t(1), 4), 64);
+        table_t expected(tableDef);
+        setUpTables(partitioned, expected, 1000);
+
+        std::vector<sortPolicy_t> sortPolicies = {{colIndex_t(0), sortOrder_e::DESC}, {colIndex_t(2), sortOrder_e::ASC}};
+        expected.sort(sortPolicies);
+
+        EXPECT_EQ(partitioned.sort(sortPolicies), expected.getRows());
+    }
+
+    TEST(partitionedTableTest, rangeSortConcatenates)
+    {
+        partitionedTable_t partitioned(tableDef, partitionSpec_t::range(colIndex_t(0), {250, 500, 750}), 64);
+        table_t expected(tableDef);
+        setUpTables(partitioned, expected, 1000);
+
+        for (const auto sortOrder : {sortOrder_e::ASC, sortOrder_e::DESC})
+        {
+            std::vector<sortPolicy_t> sortPolicies = {{colIndex_t(0), sortOrder}, {colIndex_t(2), sortOrder_e::ASC}};
+            expected.sort(sortPolicies);
+
+            EXPECT_EQ(partitioned.sort(sortPolicies), expected.getRows());
+        }
+    }
+
+    TEST(partitionedTableTest, filterAndAggregate)
+    {
+        partitionedTable_t partitioned(tableDef, partitionSpec_t::hash(colIndex_t(0), 3));
+        table_t expected(tableDef);
+        setUpTables(partitioned, expected, 1000);
+
+        std::vector<columnPredicate_t> predicates = {{colIndex_t(0), compareOp_e::LT, 100},
+                                                     {colIndex_t(1), compareOp_e::NE, std::string("3")}};
+
+        rows_t expectedMatches;
+        for (const auto i : expected.filter(predicates))
+            expectedMatches.push_back(expected.getRows()[i]);
+
+        // Shards hand back their matches one after another, so only the set of rows has to agree
+        auto matches = partitioned.filter(predicates);
+        auto byEveryColumn = expected.makeRowComparator(std::vector<sortPolicy_t>{
+            {colIndex_t(0), sortOrder_e::ASC}, {colIndex_t(1), sortOrder_e::ASC}, {colIndex_t(2), sortOrder_e::ASC}});
+        std::sort(matches.begin(), matches.end(), byEveryColumn);
+        std::sort(expectedMatches.begin(), expectedMatches.end(), byEveryColumn);
+
+        EXPECT_FALSE(matches.empty());
+        EXPECT_EQ(matches, expectedMatches);
+        EXPECT_EQ(partitioned.count(predicates), matches.size());
+
+        double total = 0;
+        for (const auto &row : expected.getRows())
+            total += std::get<double>(row[2]);
+
+        EXPECT_DOUBLE_EQ(partitioned.sum(colIndex_t(2)), total);
+    }
+
+    TEST(partitionedTableTest, shardStats)
+    {
+        // Everything lands in the first shard
+        partitionedTable_t partitioned(tableDef, partitionSpec_t::range(colIndex_t(0), {2000, 3000}));
+        for (auto i = 0; i < 900; ++i)
+            partitioned.appendRow(makeRow(i));
+
+        auto stats = partitioned.getShardStats();
+        EXPECT_EQ(stats.rowsPerShard, (std::vector<std::size_t>{900, 0, 0}));
+        EXPECT_DOUBLE_EQ(stats.imbalance, 3.0);
+
+        // Values are spread evenly over [0, 1000), so the even split is around the thirds
+        ASSERT_EQ(stats.suggestedBoundaries.size(), 2);
+        EXPECT_NEAR(std::get<int>(stats.suggestedBoundaries[0]), 333, 20);
+        EXPECT_NEAR(std::get<int>(stats.suggestedBoundaries[1]), 666, 20);
+    }
+};
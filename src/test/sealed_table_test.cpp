@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "table/sealed_table.h"
+
+// Curiously, GTEST isn't smart enough to use <=>
+auto operator==(const Color &l, const Color &r) -> bool
+{
+    std::weak_ordering cmp = l <=> r;
+    return cmp == std::weak_ordering::equivalent;
+}
+
+namespace test
+{
+    using namespace table;
+
+    auto setUpTable(std::size_t numRows) -> table_t
+    {
+        table_t t({colType_e::INTEGER, colType_e::STRING, colType_e::BOOLEAN, colType_e::DOUBLE, colType_e::COLOR});
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            const auto n = static_cast<int>(i);
+            t.appendRow({1000 + (n * 37) % 500, std::to_string(n % 7), n % 3 == 0, n * 0.5, static_cast<color_e>(n / 100 % 3)});
+        }
+
+        return t;
+    }
+
+    TEST(sealedTableTest, picksEncodings)
+    {
+        auto t = setUpTable(1000);
+        sealedTable_t sealed(t, 256);
+
+        const auto &chunk = sealed.getChunks().front();
+        EXPECT_EQ(encodingOf(chunk.getColumn(0)), encoding_e::FRAME_OF_REFERENCE);
+        EXPECT_EQ(encodingOf(chunk.getColumn(1)), encoding_e::PLAIN);
+        EXPECT_EQ(encodingOf(chunk.getColumn(2)), encoding_e::RLE);
+        EXPECT_EQ(encodingOf(chunk.getColumn(3)), encoding_e::PLAIN);
+        EXPECT_EQ(encodingOf(chunk.getColumn(4)), encoding_e::RLE);
+
+        // Once sorted on the string column, its repeats line up
+        t.sort(std::vector<sortPolicy_t>{{colIndex_t(1), sortOrder_e::ASC}});
+        sealedTable_t sortedSealed(t, 256);
+        EXPECT_EQ(encodingOf(sortedSealed.getChunks().front().getColumn(1)), encoding_e::RLE);
+    }
+
+    TEST(sealedTableTest, roundTrip)
+    {
+        auto t = setUpTable(1000);
+        sealedTable_t sealed(t, 256);
+
+        EXPECT_EQ(sealed.numRows(), 1000);
+        EXPECT_EQ(sealed.toTable().getRows(), t.getRows());
+    }
+
+    TEST(sealedTableTest, filterMatchesScan)
+    {
+        auto t = setUpTable(1000);
+        sealedTable_t sealed(t, 256);
+
+        const std::vector<columnPredicate_t> preds = {
+            {colIndex_t(0), compareOp_e::LT, 1200},
+            {colIndex_t(0), compareOp_e::GE, 100},
+            {colIndex_t(0), compareOp_e::EQ, 5000},
+            {colIndex_t(1), compareOp_e::EQ, std::string("3")},
+            {colIndex_t(2), compareOp_e::NE, true},
+            {colIndex_t(4), compareOp_e::GT, Color(color_e::RED)},
+        };
+
+        for (const auto &pred : preds)
+        {
+            auto compare = getTypeSpecificComparisonFunc(t.getTableDef()[pred.colIndex.get()]);
+
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < t.getRows().size(); ++i)
+            {
+                if (satisfies(compare.get()(t.getRows()[i][pred.colIndex.get()], pred.value), pred.op))
+                    expected.push_back(i);
+            }
+
+            EXPECT_EQ(sealed.filter(pred), expected);
+            EXPECT_EQ(sealed.count(pred), expected.size());
+        }
+    }
+
+    TEST(sealedTableTest, aggregates)
+    {
+        auto t = setUpTable(1000);
+        sealedTable_t sealed(t, 256);
+
+        double intSum = 0;
+        double doubleSum = 0;
+        for (const auto &row : t.getRows())
+        {
+            intSum += std::get<int>(row[0]);
+            doubleSum += std::get<double>(row[3]);
+        }
+
+        EXPECT_DOUBLE_EQ(sealed.sum(colIndex_t(0)), intSum);
+        EXPECT_DOUBLE_EQ(sealed.sum(colIndex_t(3)), doubleSum);
+        EXPECT_EQ(sealed.min(colIndex_t(0)), colValue_t(1000));
+        EXPECT_EQ(sealed.max(colIndex_t(0)), colValue_t(1499));
+        EXPECT_EQ(sealed.max(colIndex_t(4)), colValue_t(Color(color_e::BLUE)));
+        EXPECT_LT(sealed.bytes(), t.getRows().size() * (sizeof(row_t) + t.getTableDef().size() * sizeof(colValue_t)));
+    }
+};
@@ -158,4 +158,29 @@ namespace test
             {colIndex_t(2), sortOrder_e::ASC}};
         runTest(tPtr, std::move(rowsAfter_2), std::move(sortPolicies_2));
     }
+    TEST(tableTest, chunkedSortMatchesSort)
+    {
+        std::vector<colType_e> tableDef = {colType_e::INTEGER, colType_e::STRING};
+
+        table_t expected(tableDef);
+        table_t chunked(tableDef);
+        for (auto i = 0; i < 1000; ++i)
+        {
+            expected.appendRow({(i * 7919) % 101, std::to_string(i % 13)});
+            chunked.appendRow({(i * 7919) % 101, std::to_string(i % 13)});
+        }
+
+        std::vector<sortPolicy_t> sortPolicies = {
+            {colIndex_t(1), sortOrder_e::DESC},
+            {colIndex_t(0), sortOrder_e::ASC}};
+
+        std::vector<double> progress;
+        expected.sort(sortPolicies);
+        chunked.sort(sortPolicies, 7, [&progress](double p)
+                     { progress.push_back(p); });
+
+        EXPECT_EQ(chunked.getRows(), expected.getRows());
+        EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+        EXPECT_DOUBLE_EQ(progress.back(), 1.0);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "table/typed_table.h"
+
+// Curiously, GTEST isn't smart enough to use <=>
+auto operator==(const Color &l, const Color &r) -> bool
+{
+    std::weak_ordering cmp = l <=> r;
+    return cmp == std::weak_ordering::equivalent;
+}
+
+namespace test
+{
+    using namespace table;
+
+    using typedTable_t = typed_table_t<std::string, int, bool>;
+
+    auto setUpTypedTable() -> typedTable_t
+    {
+        typedTable_t t;
+        t.appendRow("aa", 3, true);
+        t.appendRow("bbb", 1, true);
+        t.appendRow("xx", 2, false);
+        t.appendRow("aa", 4, true);
+        t.appendRow("bbb", 0, false);
+
+        return t;
+    }
+
+    TEST(typedTableTest, sortSingleColumn)
+    {
+        auto t = setUpTypedTable();
+        t.sort<staticSortPolicy_t{1, sortOrder_e::DESC}>();
+
+        EXPECT_EQ(t.getColumn<1>(), (std::vector<int>{4, 3, 2, 1, 0}));
+        EXPECT_EQ(t.getColumn<0>(), (std::vector<std::string>{"aa", "aa", "xx", "bbb", "bbb"}));
+    }
+
+    TEST(typedTableTest, sortTieBreak)
+    {
+        auto t = setUpTypedTable();
+        t.sort<staticSortPolicy_t{2, sortOrder_e::ASC}, staticSortPolicy_t{1, sortOrder_e::ASC}>();
+
+        EXPECT_EQ(t.getColumn<1>(), (std::vector<int>{0, 2, 1, 3, 4}));
+        EXPECT_EQ(t.getColumn<2>(), (std::vector<bool>{false, false, true, true, true}));
+    }
+
+    TEST(typedTableTest, matchesDynamicTable)
+    {
+        auto typed = setUpTypedTable();
+        auto dynamic = typed.toTable();
+
+        typed.sort<staticSortPolicy_t{0, sortOrder_e::ASC}, staticSortPolicy_t{1, sortOrder_e::DESC}>();
+        dynamic.sort(std::vector<sortPolicy_t>{{colIndex_t(0), sortOrder_e::ASC}, {colIndex_t(1), sortOrder_e::DESC}});
+
+        EXPECT_EQ(typed.toTable().getRows(), dynamic.getRows());
+
+        typedTable_t roundTrip(dynamic);
+        EXPECT_EQ(roundTrip.getColumn<0>(), typed.getColumn<0>());
+        EXPECT_EQ(roundTrip.getColumn<1>(), typed.getColumn<1>());
+        EXPECT_EQ(roundTrip.getColumn<2>(), typed.getColumn<2>());
+        EXPECT_EQ(roundTrip.getRow(0), typed.getRow(0));
+    }
+};
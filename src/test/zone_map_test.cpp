@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include "table/table.h"
+
+// Curiously, GTEST isn't smart enough to use <=>
+auto operator==(const Color &l, const Color &r) -> bool
+{
+    std::weak_ordering cmp = l <=> r;
+    return cmp == std::weak_ordering::equivalent;
+}
+
+namespace test
+{
+    using namespace table;
+
+    static constexpr std::size_t zoneRows = 100;
+
+    /**
+     * @brief Rows come in batches of zoneRows, batch b holding values [b * 1000, b * 1000 + 999] in column 0
+     *
+     * @param batchOrder Order the batches are appended in
+     * @param isShuffled Whether rows inside a batch are out of order
+     */
+    auto setUpTable(const std::vector<int> &batchOrder, bool isShuffled) -> table_t
+    {
+        table_t t({colType_e::INTEGER, colType_e::STRING}, zoneRows);
+        for (const auto batch : batchOrder)
+        {
+            for (auto i = 0; i < static_cast<int>(zoneRows); ++i)
+            {
+                const auto offset = isShuffled ? (i * 37) % static_cast<int>(zoneRows) : i;
+                t.appendRow({batch * 1000 + offset * 3, std::to_string(i % 4)});
+            }
+        }
+
+        return t;
+    }
+
+    auto expectSameRows(table_t t, const std::vector<sortPolicy_t> &sortPolicies) -> void
+    {
+        auto expected = t.getRows();
+        std::sort(expected.begin(), expected.end(), t.makeRowComparator(sortPolicies));
+
+        auto topK = t.topK(sortPolicies, 150);
+        EXPECT_EQ(topK, rows_t(expected.begin(), expected.begin() + 150));
+
+        t.sort(sortPolicies);
+        EXPECT_EQ(t.getRows(), expected);
+    }
+
+    TEST(zoneMapTest, builtLazilyAndCaughtUp)
+    {
+        auto t = setUpTable({2, 0, 1}, true);
+        t.appendRow({-5, std::string("x")});
+
+        const auto &zones = t.getZoneMaps();
+        ASSERT_EQ(zones.size(), 4);
+
+        const auto &first = zones[0].getColumn(colIndex_t(0));
+        EXPECT_EQ(zones[0].numRows(), zoneRows);
+        EXPECT_EQ(first.min(), colValue_t(2000));
+        EXPECT_EQ(first.max(), colValue_t(2297));
+        EXPECT_FALSE(first.isSorted(sortOrder_e::ASC));
+        EXPECT_NEAR(first.distinctEstimate(), 100, 10);
+        EXPECT_NEAR(zones[0].getColumn(colIndex_t(1)).distinctEstimate(), 4, 1);
+
+        EXPECT_EQ(zones[3].numRows(), 1);
+        EXPECT_EQ(zones[3].getColumn(colIndex_t(0)).min(), colValue_t(-5));
+        EXPECT_TRUE(zones[3].getColumn(colIndex_t(0)).isSorted(sortOrder_e::DESC));
+
+        // Rows appended after the zone maps were built get folded into the last, partially full one
+        t.appendRow({-7, std::string("y")});
+        EXPECT_EQ(t.getZoneMaps()[3].numRows(), 2);
+        EXPECT_EQ(t.getZoneMaps()[3].getColumn(colIndex_t(0)).min(), colValue_t(-7));
+        EXPECT_EQ(t.getZoneMaps()[2].numRows(), zoneRows);
+
+        t.sort(std::vector<sortPolicy_t>{{colIndex_t(0), sortOrder_e::ASC}});
+        EXPECT_EQ(t.getZoneMaps()[0].getColumn(colIndex_t(0)).min(), colValue_t(-7));
+        EXPECT_TRUE(t.getZoneMaps()[0].getColumn(colIndex_t(0)).isSorted(sortOrder_e::ASC));
+    }
+
+    TEST(zoneMapTest, filterSkipsChunks)
+    {
+        auto t = setUpTable({2, 0, 1}, true);
+
+        const std::vector<std::vector<columnPredicate_t>> filters = {
+            {{colIndex_t(0), compareOp_e::GE, 1000}, {colIndex_t(0), compareOp_e::LT, 1100}},
+            {{colIndex_t(0), compareOp_e::EQ, 2003}},
+            {{colIndex_t(0), compareOp_e::NE, 2003}, {colIndex_t(1), compareOp_e::EQ, std::string("2")}},
+            {{colIndex_t(0), compareOp_e::GT, 5000}},
+        };
+
+        for (const auto &predicates : filters)
+        {
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < t.getRows().size(); ++i)
+            {
+                auto isMatch = std::all_of(predicates.begin(), predicates.end(), [&](const columnPredicate_t &pred)
+                                           {
+                                               auto compare = getTypeSpecificComparisonFunc(t.getTableDef()[pred.colIndex.get()]);
+                                               return satisfies(compare.get()(t.getRows()[i][pred.colIndex.get()], pred.value), pred.op); });
+                if (isMatch)
+                    expected.push_back(i);
+            }
+
+            EXPECT_EQ(t.filter(predicates), expected);
+        }
+    }
+
+    TEST(zoneMapTest, sortDisjointChunks)
+    {
+        expectSameRows(setUpTable({0, 1, 2}, false), {{colIndex_t(0), sortOrder_e::ASC}});
+        expectSameRows(setUpTable({2, 0, 1}, false), {{colIndex_t(0), sortOrder_e::ASC}});
+        expectSameRows(setUpTable({2, 0, 1}, true), {{colIndex_t(0), sortOrder_e::DESC}});
+        expectSameRows(setUpTable({2, 0, 1}, true), {{colIndex_t(0), sortOrder_e::ASC}, {colIndex_t(1), sortOrder_e::DESC}});
+    }
+
+    TEST(zoneMapTest, sortOverlappingChunks)
+    {
+        auto t = setUpTable({2, 0, 1}, true);
+        t.appendRow({1500, std::string("x")});
+        t.appendRow({5, std::string("y")});
+
+        expectSameRows(t, {{colIndex_t(0), sortOrder_e::ASC}});
+        expectSameRows(t, {{colIndex_t(1), sortOrder_e::ASC}, {colIndex_t(0), sortOrder_e::DESC}});
+    }
+};
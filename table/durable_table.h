@@ -0,0 +1,174 @@
+#ifndef INCLUDE_DURABLE_TABLE_H
+#define INCLUDE_DURABLE_TABLE_H
+
+#include <cstdio>
+#include <memory>
+
+#include "table.h"
+#include "wal.h"
+
+namespace table
+{
+    enum class durability_e : bool
+    {
+        SYNC, // appendRow returns once the row is on disk
+        ASYNC // appendRow returns right away, the row hits disk within groupCommitConfig_t::maxDelay
+    };
+
+    /**
+     * @brief A table_t whose appends survive a crash
+     *
+     *        Every append is logged to <path>.wal before it's applied. checkpoint() writes the whole table to
+     *        <path>.checkpoint and empties the log, and constructing one rebuilds the table from both
+     *
+     *        Appends from several threads share fsyncs (group commit), so SYNC appends get cheaper the more
+     *        threads are appending at once
+     */
+    class durableTable_t
+    {
+    public:
+        /**
+         * @brief Rebuild the table from whatever is on disk at path (nothing is fine) and start logging to it
+         */
+        durableTable_t(std::string path,
+                       std::vector<colType_e> tableDef,
+                       durability_e durability = durability_e::SYNC,
+                       groupCommitConfig_t config = {})
+            : m_path(std::move(path)),
+              m_durability(durability),
+              m_table(std::move(tableDef))
+        {
+            // Check both files were written for this table before replaying anything from either
+            auto checkpoint = wal::readFile(checkpointPath());
+            if (checkpoint.has_value())
+                wal::checkTableDef(checkpoint.value(), m_table.getTableDef(), checkpointPath());
+
+            // A crash while the log was first being created leaves part of a header behind, start that log over
+            auto log = wal::hasTornHeader(logPath(), m_table.getTableDef()) ? std::nullopt : wal::readFile(logPath());
+            if (log.has_value())
+                wal::checkTableDef(log.value(), m_table.getTableDef(), logPath());
+
+            // Rows covered by the checkpoint come first, then anything logged after it
+            lsn_t lastLsn = 0;
+            if (checkpoint.has_value())
+            {
+                lastLsn = checkpoint->baseLsn;
+
+                for (auto &[_, row] : checkpoint->records)
+                    m_table.appendRow(std::move(row));
+            }
+
+            std::optional<std::size_t> validBytes;
+            if (log.has_value())
+            {
+                validBytes = log->validBytes;
+
+                // A crash between writing a checkpoint and emptying the log leaves rows that are in both
+                const auto checkpointLsn = lastLsn;
+                for (auto &[lsn, row] : log->records)
+                {
+                    if (lsn <= checkpointLsn)
+                        continue;
+
+                    m_table.appendRow(std::move(row));
+                    lastLsn = lsn;
+                }
+            }
+
+            m_log = std::make_unique<writeAheadLog_t>(logPath(), m_table.getTableDef(), config, validBytes, lastLsn + 1);
+        }
+
+        /**
+         * @brief Log the row, then add it to the table
+         *
+         *        If writing the log ever fails, this and every later append throw that error and leave the table
+         *        alone. Rows appended before the failure may already be in the table without being on disk
+         *        (every SYNC append among them threw), so the table shouldn't be trusted past that point
+         */
+        auto appendRow(row_t &&row) -> void
+        {
+            lsn_t lsn;
+            {
+                std::lock_guard lock(m_mutex);
+                lsn = m_log->append(row); // Throws before touching the table if the log has failed
+                m_table.appendRow(std::move(row));
+            }
+
+            // Wait outside the lock so other appends can pile into the same fsync
+            if (m_durability == durability_e::SYNC)
+                m_log->waitDurable(lsn);
+        }
+
+        /**
+         * @brief Make sure every row appended so far is on disk, useful in ASYNC mode
+         */
+        auto flush() -> void { m_log->flush(); }
+
+        /**
+         * @brief Write the whole table out and empty the log, so the next open doesn't replay as much
+         *
+         *        The checkpoint is written to a temporary file and renamed into place, a crash at any point
+         *        leaves either the old or the new checkpoint plus a log that covers the difference
+         */
+        auto checkpoint() -> void
+        {
+            std::lock_guard lock(m_mutex);
+            m_log->flush();
+
+            std::string contents;
+            wal::writeHeader(contents, m_log->lastLsn(), m_table.getTableDef());
+            for (const auto &row : m_table.getRows())
+                wal::writeRecord(contents, 0, row);
+
+            const auto tmpPath = checkpointPath() + ".tmp";
+            auto fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0)
+                wal::throwErrno("open " + tmpPath);
+
+            try
+            {
+                wal::writeAll(fd, contents.data(), contents.size());
+                if (::fsync(fd) != 0)
+                    wal::throwErrno("fsync " + tmpPath);
+            }
+            catch (...)
+            {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+
+            if (std::rename(tmpPath.c_str(), checkpointPath().c_str()) != 0)
+                wal::throwErrno("rename " + tmpPath);
+            wal::syncParentDirectory(checkpointPath());
+
+            m_log->truncate();
+        }
+
+        /**
+         * @brief Only safe to look at while nobody is appending
+         */
+        auto getTable() const noexcept -> const table_t & { return m_table; }
+
+    private:
+        // Prevent copying
+        durableTable_t(const durableTable_t &) = delete;
+        durableTable_t &operator=(const durableTable_t &) = delete;
+
+        // Prevent moving
+        durableTable_t(durableTable_t &&) = delete;
+        durableTable_t &operator=(durableTable_t &&) = delete;
+
+        auto logPath() const -> std::string { return m_path + ".wal"; }
+        auto checkpointPath() const -> std::string { return m_path + ".checkpoint"; }
+
+        std::string m_path;
+        durability_e m_durability;
+
+        std::mutex m_mutex; // Keeps the log and the table in the same order
+        table_t m_table;
+        std::unique_ptr<writeAheadLog_t> m_log;
+    };
+}
+
+#endif // INCLUDE_DURABLE_TABLE_H
@@ -0,0 +1,313 @@
+#ifndef INCLUDE_ENCODINGS_H
+#define INCLUDE_ENCODINGS_H
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+#include "predicate.h"
+#include "sort_helpers.h"
+
+namespace table
+{
+    template <typename T>
+    concept is_summable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+    /**
+     * @brief Calls onRange(begin, end) for every maximal stretch of consecutive units in [0, size) that isMatch
+     */
+    template <typename P, typename F>
+    static inline auto forEachMatchingStretch(std::size_t size, P &&isMatch, F &&onRange) -> void
+    {
+        std::size_t begin = 0;
+        while (true)
+        {
+            while (begin < size && !isMatch(begin))
+                ++begin;
+
+            if (begin == size)
+                return;
+
+            auto end = begin + 1;
+            while (end < size && isMatch(end))
+                ++end;
+
+            onRange(begin, end);
+            begin = end;
+        }
+    }
+
+    /**
+     * @brief No encoding at all, the fallback for anything we don't know how to shrink
+     */
+    template <ColumnType T>
+    class plainColumn_t
+    {
+    public:
+        using value_type = T;
+
+        auto append(const T &value) -> void { m_values.push_back(value); }
+
+        auto size() const noexcept -> std::size_t { return m_values.size(); }
+        auto at(std::size_t i) const -> T { return m_values[i]; }
+        auto bytes() const noexcept -> std::size_t { return m_values.capacity() * sizeof(T); }
+
+        /**
+         * @brief Calls onRange(begin, end) for every stretch of consecutive rows satisfying "value op constant"
+         */
+        template <typename F>
+        auto forEachMatchingRange(compareOp_e op, const T &constant, F &&onRange) const -> void
+        {
+            forEachMatchingStretch(
+                m_values.size(), [&](std::size_t i)
+                { return satisfies(compareValues<T>(m_values[i], constant), op); },
+                onRange);
+        }
+
+        auto sum() const -> double
+            requires is_summable<T>
+        {
+            double total = 0;
+            for (const auto &value : m_values)
+                total += value;
+
+            return total;
+        }
+
+        auto min() const -> T { return *std::min_element(m_values.begin(), m_values.end(), lessThan); }
+        auto max() const -> T { return *std::max_element(m_values.begin(), m_values.end(), lessThan); }
+
+    private:
+        static auto lessThan(const T &lhs, const T &rhs) -> bool { return compareValues<T>(lhs, rhs) < 0; }
+
+        std::vector<T> m_values;
+    };
+
+    /**
+     * @brief Run-length encoding, one copy of the value per run of equal values
+     *
+     *        Everything that looks at values (filters, aggregates) does so once per run instead of once per row
+     */
+    template <ColumnType T>
+    class rleColumn_t
+    {
+    public:
+        using value_type = T;
+
+        auto append(const T &value) -> void
+        {
+            if (!m_values.empty() && compareValues<T>(m_values.back(), value) == 0)
+            {
+                ++m_runEnds.back();
+                return;
+            }
+
+            m_values.push_back(value);
+            m_runEnds.push_back(size() + 1);
+        }
+
+        auto size() const noexcept -> std::size_t { return m_runEnds.empty() ? 0 : m_runEnds.back(); }
+        auto numRuns() const noexcept -> std::size_t { return m_values.size(); }
+        auto bytes() const noexcept -> std::size_t { return m_values.capacity() * sizeof(T) + m_runEnds.capacity() * sizeof(uint32_t); }
+
+        auto at(std::size_t i) const -> T
+        {
+            auto run = std::upper_bound(m_runEnds.begin(), m_runEnds.end(), i) - m_runEnds.begin();
+            return m_values[run];
+        }
+
+        /**
+         * @brief Calls onRange(begin, end) for every stretch of consecutive rows satisfying "value op constant"
+         *
+         *        Matching runs next to each other are handed out as a single range, so the cost is per run
+         */
+        template <typename F>
+        auto forEachMatchingRange(compareOp_e op, const T &constant, F &&onRange) const -> void
+        {
+            forEachMatchingStretch(
+                m_values.size(), [&](std::size_t run)
+                { return satisfies(compareValues<T>(m_values[run], constant), op); },
+                [&](std::size_t firstRun, std::size_t endRun)
+                { onRange(firstRun == 0 ? 0 : m_runEnds[firstRun - 1], m_runEnds[endRun - 1]); });
+        }
+
+        auto sum() const -> double
+            requires is_summable<T>
+        {
+            double total = 0;
+            std::size_t runBegin = 0;
+            for (std::size_t run = 0; run < m_values.size(); ++run)
+            {
+                total += static_cast<double>(m_values[run]) * (m_runEnds[run] - runBegin);
+                runBegin = m_runEnds[run];
+            }
+
+            return total;
+        }
+
+        auto min() const -> T { return *std::min_element(m_values.begin(), m_values.end(), lessThan); }
+        auto max() const -> T { return *std::max_element(m_values.begin(), m_values.end(), lessThan); }
+
+    private:
+        static auto lessThan(const T &lhs, const T &rhs) -> bool { return compareValues<T>(lhs, rhs) < 0; }
+
+        std::vector<T> m_values;         // One value per run
+        std::vector<uint32_t> m_runEnds; // Parallel to m_values, exclusive end row of each run
+    };
+
+    /**
+     * @brief Frame-of-reference bit packing for integers
+     *
+     *        Every value is stored as (value - reference) using only as many bits as the widest offset needs.
+     *        Comparisons against a constant are moved into the offset domain so values never get unpacked
+     *
+     *  NOTE: Built in one go since the reference and bit width depend on every value
+     */
+    class forColumn_t
+    {
+    public:
+        using value_type = int;
+
+        template <typename C>
+        explicit forColumn_t(const C &values)
+            : m_size(values.size())
+        {
+            if (values.empty())
+                return;
+
+            auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+            m_reference = *minIt;
+            m_maxOffset = offsetOf(*maxIt);
+            m_bitWidth = std::bit_width(m_maxOffset);
+
+            m_words.assign((m_size * m_bitWidth + 63) / 64, 0);
+            for (std::size_t i = 0; i < m_size; ++i)
+                pack(i, offsetOf(values[i]));
+        }
+
+        auto size() const noexcept -> std::size_t { return m_size; }
+        auto bitWidth() const noexcept -> unsigned { return m_bitWidth; }
+        auto bytes() const noexcept -> std::size_t { return m_words.capacity() * sizeof(uint64_t); }
+        auto at(std::size_t i) const -> int { return static_cast<int>(m_reference + static_cast<int64_t>(unpack(i))); }
+
+        /**
+         * @brief Calls onRange(begin, end) for every stretch of consecutive rows satisfying "value op constant"
+         */
+        template <typename F>
+        auto forEachMatchingRange(compareOp_e op, int constant, F &&onRange) const -> void
+        {
+            // Where does the constant land relative to the frame? Anything outside of it is decided for every row at once
+            const auto target = static_cast<int64_t>(constant) - m_reference;
+            if (target < 0 || target > static_cast<int64_t>(m_maxOffset))
+            {
+                const auto everyRow = target < 0 ? satisfies(std::weak_ordering::greater, op)
+                                                 : satisfies(std::weak_ordering::less, op);
+                if (everyRow && m_size > 0)
+                    onRange(0, m_size);
+
+                return;
+            }
+
+            const auto packedTarget = static_cast<uint32_t>(target);
+            forEachMatchingStretch(
+                m_size, [&](std::size_t i)
+                { return satisfies(unpack(i) <=> packedTarget, op); },
+                onRange);
+        }
+
+        auto sum() const -> double
+        {
+            uint64_t offsetTotal = 0;
+            for (std::size_t i = 0; i < m_size; ++i)
+                offsetTotal += unpack(i);
+
+            return static_cast<double>(m_reference) * m_size + static_cast<double>(offsetTotal);
+        }
+
+        auto min() const -> int { return m_reference; }
+        auto max() const -> int { return static_cast<int>(m_reference + static_cast<int64_t>(m_maxOffset)); }
+
+    private:
+        auto offsetOf(int value) const noexcept -> uint32_t { return static_cast<uint32_t>(static_cast<int64_t>(value) - m_reference); }
+
+        auto pack(std::size_t i, uint32_t offset) -> void
+        {
+            if (m_bitWidth == 0)
+                return;
+
+            const auto bitPos = i * m_bitWidth;
+            const auto word = bitPos / 64;
+            const auto shift = bitPos % 64;
+
+            m_words[word] |= static_cast<uint64_t>(offset) << shift;
+            if (shift + m_bitWidth > 64)
+                m_words[word + 1] |= static_cast<uint64_t>(offset) >> (64 - shift);
+        }
+
+        auto unpack(std::size_t i) const noexcept -> uint32_t
+        {
+            if (m_bitWidth == 0)
+                return 0;
+
+            const auto bitPos = i * m_bitWidth;
+            const auto word = bitPos / 64;
+            const auto shift = bitPos % 64;
+
+            auto bits = m_words[word] >> shift;
+            if (shift + m_bitWidth > 64)
+                bits |= m_words[word + 1] << (64 - shift);
+
+            return static_cast<uint32_t>(bits & ((uint64_t(1) << m_bitWidth) - 1));
+        }
+
+        std::size_t m_size;
+        int m_reference = 0;     // Smallest value, every value is stored relative to it
+        uint32_t m_maxOffset = 0; // Largest (value - reference)
+        unsigned m_bitWidth = 0;  // Bits used per value, 0 when every value is the same
+
+        std::vector<uint64_t> m_words; // Offsets packed back to back, may straddle words
+    };
+
+    /**
+     * @brief Every encoding of every column type, plus the integer only frame-of-reference encoding
+     */
+    template <typename V>
+    struct encodedColumnFor;
+
+    template <typename... Ts>
+    struct encodedColumnFor<std::variant<Ts...>>
+    {
+        using type = std::variant<plainColumn_t<Ts>..., rleColumn_t<Ts>..., forColumn_t>;
+    };
+
+    using encodedColumn_t = encodedColumnFor<colValue_t>::type;
+
+    enum class encoding_e : uint8_t
+    {
+        PLAIN,
+        RLE,
+        FRAME_OF_REFERENCE
+    };
+
+    /**
+     * @brief Which encoding a column is using, mostly useful for tests and reporting
+     */
+    static inline auto encodingOf(const encodedColumn_t &col) -> encoding_e
+    {
+        return std::visit([]<typename E>(const E &) -> encoding_e
+                          {
+                              if constexpr (std::is_same_v<E, forColumn_t>)
+                                  return encoding_e::FRAME_OF_REFERENCE;
+                              else if constexpr (std::is_same_v<E, rleColumn_t<typename E::value_type>>)
+                                  return encoding_e::RLE;
+                              else
+                                  return encoding_e::PLAIN; },
+                          col);
+    }
+}
+
+#endif // INCLUDE_ENCODINGS_H
@@ -0,0 +1,485 @@
+#ifndef INCLUDE_PARTITIONED_TABLE_H
+#define INCLUDE_PARTITIONED_TABLE_H
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "table.h"
+
+namespace table
+{
+    enum class partitionScheme_e : bool
+    {
+        HASH, // Spread rows evenly, no locality
+        RANGE // Shard i holds values in [boundaries[i - 1], boundaries[i]), so shards are ordered
+    };
+
+    /**
+     * @brief How rows get assigned to shards
+     */
+    struct partitionSpec_t
+    {
+        static auto hash(colIndex_t colIndex, std::size_t numShards) -> partitionSpec_t
+        {
+            return {partitionScheme_e::HASH, colIndex, numShards, {}};
+        }
+
+        /**
+         * @param boundaries Ascending split points, there's one more shard than boundaries
+         */
+        static auto range(colIndex_t colIndex, std::vector<colValue_t> boundaries) -> partitionSpec_t
+        {
+            // Shards are found with a binary search over the boundaries, which only works if they're in order
+            assert(std::all_of(boundaries.begin(), boundaries.end(), [&boundaries](const colValue_t &b)
+                               { return b.index() == boundaries.front().index(); }));
+            assert(std::is_sorted(boundaries.begin(), boundaries.end(), [](const colValue_t &lhs, const colValue_t &rhs)
+                                  {
+                                      // Same enum <-> variant index hack as table_t::isRowValid
+                                      return getTypeSpecificComparisonFunc(static_cast<colType_e>(lhs.index())).get()(lhs, rhs) < 0; }));
+
+            const auto numShards = boundaries.size() + 1;
+            return {partitionScheme_e::RANGE, colIndex, numShards, std::move(boundaries)};
+        }
+
+        partitionScheme_e scheme;
+        colIndex_t colIndex; // Which column decides the shard
+        std::size_t numShards;
+        std::vector<colValue_t> boundaries; // Only used for RANGE
+    };
+
+    /**
+     * @brief What a rebalance would need to know
+     */
+    struct shardStats_t
+    {
+        std::vector<std::size_t> rowsPerShard;
+        double imbalance; // Largest shard over the average shard, 1.0 is perfectly balanced
+
+        // RANGE boundaries that would split the current rows evenly (estimated from a sample of each shard)
+        std::vector<colValue_t> suggestedBoundaries;
+    };
+
+    /**
+     * @brief One table_t and the only thread allowed to touch it
+     *
+     *        Appends are queued up and applied in batches. Anything else that needs the table is submitted
+     *        as a task and runs on the shard's thread after every append queued before it
+     */
+    class shard_t
+    {
+    public:
+        shard_t(const std::vector<colType_e> &tableDef, std::size_t zoneRows)
+            : m_table(tableDef, zoneRows),
+              m_worker([this]
+                       { workerLoop(); }) {}
+
+        ~shard_t()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cv.notify_one();
+            m_worker.join();
+        }
+
+        auto appendRow(row_t &&row) -> void
+        {
+            bool wasIdle;
+            {
+                std::lock_guard lock(m_mutex);
+                wasIdle = m_pendingRows.empty() && m_pendingTasks.empty();
+                m_pendingRows.emplace_back(std::move(row));
+            }
+
+            if (wasIdle)
+                m_cv.notify_one();
+        }
+
+        /**
+         * @brief Run f(table) on the shard's thread
+         */
+        template <typename F>
+        auto submit(F &&f) -> std::future<std::invoke_result_t<F, table_t &>>
+        {
+            using result_t = std::invoke_result_t<F, table_t &>;
+
+            auto task = std::make_shared<std::packaged_task<result_t(table_t &)>>(std::forward<F>(f));
+            auto result = task->get_future();
+            {
+                std::lock_guard lock(m_mutex);
+                m_pendingTasks.emplace_back([task](table_t &t)
+                                            { (*task)(t); });
+            }
+            m_cv.notify_one();
+
+            return result;
+        }
+
+    private:
+        // Prevent copying
+        shard_t(const shard_t &) = delete;
+        shard_t &operator=(const shard_t &) = delete;
+
+        // Prevent moving
+        shard_t(shard_t &&) = delete;
+        shard_t &operator=(shard_t &&) = delete;
+
+        auto workerLoop() -> void
+        {
+            rows_t rows;
+            std::deque<std::function<void(table_t &)>> tasks;
+
+            while (true)
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_cv.wait(lock, [this]
+                              { return m_stopping || !m_pendingRows.empty() || !m_pendingTasks.empty(); });
+
+                    // Finish off anything still queued before stopping
+                    if (m_stopping && m_pendingRows.empty() && m_pendingTasks.empty())
+                        return;
+
+                    rows.swap(m_pendingRows);
+                    tasks.swap(m_pendingTasks);
+                }
+
+                // Rows first, every task was submitted after at least these rows were queued
+                for (auto &row : rows)
+                    m_table.appendRow(std::move(row));
+
+                for (auto &task : tasks)
+                    task(m_table);
+
+                rows.clear();
+                tasks.clear();
+            }
+        }
+
+        table_t m_table;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        rows_t m_pendingRows;
+        std::deque<std::function<void(table_t &)>> m_pendingTasks;
+        bool m_stopping = false;
+
+        std::thread m_worker; // Last, so everything it uses exists before it starts
+    };
+
+    /**
+     * @brief A table split across several shards, each appended to by its own thread
+     *
+     *        Queries are scattered to every shard, run there in parallel, and the pieces are gathered back
+     *        together on the calling thread
+     */
+    class partitionedTable_t
+    {
+    public:
+        partitionedTable_t(std::vector<colType_e> tableDef, partitionSpec_t spec, std::size_t zoneRows = defaultChunkRows)
+            : m_schema(std::move(tableDef)),
+              m_spec(std::move(spec)),
+              m_partitionCompare(getTypeSpecificComparisonFunc(m_schema.getTableDef()[m_spec.colIndex.get()]))
+        {
+            assert(m_spec.numShards > 0);
+            assert(m_spec.colIndex.get() < static_cast<int>(m_schema.getTableDef().size()));
+            assert(std::all_of(m_spec.boundaries.begin(), m_spec.boundaries.end(), [this](const colValue_t &b)
+                               { return b.index() == static_cast<std::size_t>(m_schema.getTableDef()[m_spec.colIndex.get()]); }));
+
+            m_shards.reserve(m_spec.numShards);
+            for (std::size_t i = 0; i < m_spec.numShards; ++i)
+                m_shards.emplace_back(std::make_unique<shard_t>(m_schema.getTableDef(), zoneRows));
+        }
+
+        auto appendRow(row_t &&row) -> void
+        {
+            // Checked here since the shard's own check only happens later, on its worker thread
+            assert(isRowValid(row));
+            const auto shard = shardFor(row[m_spec.colIndex.get()]);
+            m_shards[shard]->appendRow(std::move(row));
+        }
+
+        auto numShards() const noexcept -> std::size_t { return m_shards.size(); }
+        auto getTableDef() const noexcept -> const std::vector<colType_e> & { return m_schema.getTableDef(); }
+
+        /**
+         * @brief Every row, in sorted order
+         *
+         *        Each shard sorts itself in parallel. If the table is range partitioned on the leading sort column
+         *        the shards are already in order relative to each other and just get concatenated, otherwise
+         *        the sorted shards are k-way merged
+         */
+        template <typename C = std::vector<sortPolicy_t>>
+        auto sort(const C &sortPolicies) -> rows_t
+        {
+            auto sortedShards = scatter([&sortPolicies](table_t &t)
+                                        {
+                                            t.sort(sortPolicies);
+                                            return t.getRows(); });
+
+            if (isRangePartitionedOn(sortPolicies))
+            {
+                if (std::begin(sortPolicies)->sortOrder == sortOrder_e::DESC)
+                    std::reverse(sortedShards.begin(), sortedShards.end());
+
+                return concatenate(std::move(sortedShards));
+            }
+
+            return merge(std::move(sortedShards), m_schema.makeRowComparator(sortPolicies));
+        }
+
+        /**
+         * @brief Rows satisfying every predicate, grouped by shard
+         */
+        template <typename C = std::vector<columnPredicate_t>>
+        auto filter(const C &predicates) -> rows_t
+        {
+            return concatenate(scatter([&predicates](table_t &t)
+                                       {
+                                           rows_t matches;
+                                           for (const auto i : t.filter(predicates))
+                                               matches.push_back(t.getRows()[i]);
+
+                                           return matches; }));
+        }
+
+        template <typename C = std::vector<columnPredicate_t>>
+        auto count(const C &predicates) -> std::size_t
+        {
+            auto counts = scatter([&predicates](table_t &t)
+                                  { return t.filter(predicates).size(); });
+
+            return std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+        }
+
+        /**
+         * @brief Sum of an INTEGER or DOUBLE column
+         */
+        auto sum(colIndex_t colIndex) -> double
+        {
+            assert(m_schema.getTableDef()[colIndex.get()] == colType_e::INTEGER ||
+                   m_schema.getTableDef()[colIndex.get()] == colType_e::DOUBLE);
+
+            auto sums = scatter([colIndex](table_t &t)
+                                {
+                                    double total = 0;
+                                    for (const auto &row : t.getRows())
+                                        total += std::visit([]<typename T>(const T &v) -> double
+                                                            {
+                                                                if constexpr (std::is_arithmetic_v<T>)
+                                                                    return v;
+                                                                else
+                                                                    return 0; },
+                                                            row[colIndex.get()]);
+
+                                    return total; });
+
+            return std::accumulate(sums.begin(), sums.end(), 0.0);
+        }
+
+        /**
+         * @brief Block until every row appended so far has landed in its shard
+         */
+        auto flush() -> void
+        {
+            scatter([](table_t &)
+                    { return true; });
+        }
+
+        auto getShardStats() -> shardStats_t
+        {
+            static constexpr std::size_t samplesPerShard = 1024;
+
+            const auto colIndex = m_spec.colIndex;
+            auto samples = scatter([colIndex](table_t &t)
+                                   {
+                                       // Every step'th value stands in for step rows
+                                       const auto &rows = t.getRows();
+                                       const auto step = std::max<std::size_t>(1, rows.size() / samplesPerShard);
+
+                                       std::vector<std::pair<colValue_t, std::size_t>> sample;
+                                       for (std::size_t i = 0; i < rows.size(); i += step)
+                                           sample.emplace_back(rows[i][colIndex.get()], std::min(step, rows.size() - i));
+
+                                       return std::make_pair(rows.size(), std::move(sample)); });
+
+            shardStats_t stats;
+            std::vector<std::pair<colValue_t, std::size_t>> weighted;
+            for (auto &[numRows, sample] : samples)
+            {
+                stats.rowsPerShard.push_back(numRows);
+                std::move(sample.begin(), sample.end(), std::back_inserter(weighted));
+            }
+
+            const auto totalRows = std::accumulate(stats.rowsPerShard.begin(), stats.rowsPerShard.end(), std::size_t(0));
+            const auto largest = *std::max_element(stats.rowsPerShard.begin(), stats.rowsPerShard.end());
+            stats.imbalance = totalRows == 0 ? 1.0 : static_cast<double>(largest) * m_shards.size() / totalRows;
+
+            // Walk the sample in order and cut wherever another 1 / numShards of the rows has gone by
+            std::sort(weighted.begin(), weighted.end(), [this](const auto &lhs, const auto &rhs)
+                      { return m_partitionCompare.get()(lhs.first, rhs.first) < 0; });
+
+            std::size_t seen = 0;
+            for (const auto &[value, weight] : weighted)
+            {
+                seen += weight;
+                const auto nextCut = (stats.suggestedBoundaries.size() + 1) * totalRows / m_shards.size();
+                if (stats.suggestedBoundaries.size() + 1 < m_shards.size() && seen >= nextCut)
+                    stats.suggestedBoundaries.push_back(value);
+            }
+
+            return stats;
+        }
+
+    private:
+        // Prevent copying
+        partitionedTable_t(const partitionedTable_t &) = delete;
+        partitionedTable_t &operator=(const partitionedTable_t &) = delete;
+
+        // Prevent moving
+        partitionedTable_t(partitionedTable_t &&) = delete;
+        partitionedTable_t &operator=(partitionedTable_t &&) = delete;
+
+        auto shardFor(const colValue_t &value) const -> std::size_t
+        {
+            switch (m_spec.scheme)
+            {
+            case partitionScheme_e::HASH:
+                return hashValue(value) % m_shards.size();
+            case partitionScheme_e::RANGE:
+            {
+                auto it = std::upper_bound(m_spec.boundaries.begin(), m_spec.boundaries.end(), value, [this](const colValue_t &lhs, const colValue_t &rhs)
+                                           { return m_partitionCompare.get()(lhs, rhs) < 0; });
+
+                return it - m_spec.boundaries.begin();
+            }
+            }
+        }
+
+        auto isRowValid(const row_t &row) const noexcept -> bool
+        {
+            const auto &tableDef = m_schema.getTableDef();
+            if (row.size() != tableDef.size())
+                return false;
+
+            // Same enum <-> variant index hack as table_t::isRowValid
+            for (std::size_t i = 0; i < tableDef.size(); ++i)
+            {
+                if (row[i].index() != static_cast<std::size_t>(tableDef[i]))
+                    return false;
+            }
+
+            return true;
+        }
+
+        template <typename C>
+        auto isRangePartitionedOn(const C &sortPolicies) const -> bool
+        {
+            return m_spec.scheme == partitionScheme_e::RANGE &&
+                   std::begin(sortPolicies) != std::end(sortPolicies) &&
+                   std::begin(sortPolicies)->colIndex.get() == m_spec.colIndex.get();
+        }
+
+        /**
+         * @brief Run f(table) on every shard at once, results come back in shard order
+         *
+         *        f usually refers to things on the caller's stack, so this never returns (or throws) while any
+         *        shard could still be running it. If some shards throw, the first one's exception is rethrown
+         */
+        template <typename F>
+        auto scatter(F &&f) -> std::vector<std::invoke_result_t<F, table_t &>>
+        {
+            std::vector<std::future<std::invoke_result_t<F, table_t &>>> futures;
+            const auto waitForAll = [&futures]
+            {
+                for (auto &future : futures)
+                    future.wait();
+            };
+
+            try
+            {
+                futures.reserve(m_shards.size());
+                for (auto &shard : m_shards)
+                    futures.push_back(shard->submit(f));
+            }
+            catch (...)
+            {
+                waitForAll();
+                throw;
+            }
+
+            waitForAll();
+
+            // Every shard is done with f by now, so bailing out on the first failure leaves nothing behind
+            std::vector<std::invoke_result_t<F, table_t &>> results;
+            results.reserve(futures.size());
+            for (auto &future : futures)
+                results.push_back(future.get());
+
+            return results;
+        }
+
+        static auto concatenate(std::vector<rows_t> &&pieces) -> rows_t
+        {
+            rows_t rows;
+            for (auto &piece : pieces)
+                std::move(piece.begin(), piece.end(), std::back_inserter(rows));
+
+            return rows;
+        }
+
+        /**
+         * @brief K-way merge of individually sorted runs of rows
+         */
+        static auto merge(std::vector<rows_t> &&runs, sortHelper_t compare) -> rows_t
+        {
+            using cursor_t = std::pair<std::size_t, std::size_t>; // (run, position within run)
+
+            // Min-heap on the row each cursor points at
+            auto isAfter = [&runs, &compare](const cursor_t &lhs, const cursor_t &rhs)
+            {
+                return compare(runs[rhs.first][rhs.second], runs[lhs.first][lhs.second]);
+            };
+
+            std::vector<cursor_t> heap;
+            std::size_t totalRows = 0;
+            for (std::size_t run = 0; run < runs.size(); ++run)
+            {
+                totalRows += runs[run].size();
+                if (!runs[run].empty())
+                    heap.emplace_back(run, 0);
+            }
+            std::make_heap(heap.begin(), heap.end(), isAfter);
+
+            rows_t rows;
+            rows.reserve(totalRows);
+            while (!heap.empty())
+            {
+                std::pop_heap(heap.begin(), heap.end(), isAfter);
+                auto &[run, pos] = heap.back();
+                rows.push_back(std::move(runs[run][pos]));
+
+                if (++pos < runs[run].size())
+                    std::push_heap(heap.begin(), heap.end(), isAfter);
+                else
+                    heap.pop_back();
+            }
+
+            return rows;
+        }
+
+        table_t m_schema; // Never holds rows, it's here for the table definition and building comparators
+        partitionSpec_t m_spec;
+        compareFunc_f m_partitionCompare; // Compares values of the partition column
+
+        std::vector<std::unique_ptr<shard_t>> m_shards;
+    };
+}
+
+#endif // INCLUDE_PARTITIONED_TABLE_H
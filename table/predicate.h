@@ -0,0 +1,54 @@
+#ifndef INCLUDE_PREDICATE_H
+#define INCLUDE_PREDICATE_H
+
+#include <compare>
+#include <cstdint>
+
+#include "sort_helpers.h"
+
+namespace table
+{
+    enum class compareOp_e : uint8_t
+    {
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE
+    };
+
+    /**
+     * @brief Does "value <op> constant" hold given how value compares to the constant
+     */
+    static inline auto satisfies(std::weak_ordering wo, compareOp_e op) noexcept -> bool
+    {
+        switch (op)
+        {
+        case compareOp_e::EQ:
+            return wo == 0;
+        case compareOp_e::NE:
+            return wo != 0;
+        case compareOp_e::LT:
+            return wo < 0;
+        case compareOp_e::LE:
+            return wo <= 0;
+        case compareOp_e::GT:
+            return wo > 0;
+        case compareOp_e::GE:
+            return wo >= 0;
+        }
+    }
+
+    /**
+     * @brief A condition on a single column, "row[colIndex] <op> value"
+     */
+    struct columnPredicate_t
+    {
+        colIndex_t colIndex;
+        compareOp_e op;
+        colValue_t value; // Must hold the same type as the column
+    };
+}
+
+#endif // INCLUDE_PREDICATE_H
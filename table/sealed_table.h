@@ -0,0 +1,311 @@
+#ifndef INCLUDE_SEALED_TABLE_H
+#define INCLUDE_SEALED_TABLE_H
+
+#include <optional>
+
+#include "encodings.h"
+#include "table.h"
+
+namespace table
+{
+    /**
+     * @brief Fixed block of rows stored column by column, each column in whichever encoding suits it
+     */
+    class sealedChunk_t
+    {
+    public:
+        /**
+         * @brief Encode rows [begin, end) of a table
+         *
+         *        BOOLEAN and COLOR columns have very few distinct values so they are run-length encoded,
+         *        INTEGER columns are bit packed, and the column the table was just sorted on is run-length
+         *        encoded as long as that actually produces long enough runs
+         */
+        sealedChunk_t(const table_t &t, std::size_t begin, std::size_t end)
+            : m_numRows(end - begin)
+        {
+            const auto &tableDef = t.getTableDef();
+            const auto &sortedBy = t.getSortedBy();
+
+            m_cols.reserve(tableDef.size());
+            for (std::size_t col = 0; col < tableDef.size(); ++col)
+            {
+                const auto isSorted = sortedBy.has_value() && sortedBy->colIndex.get() == static_cast<int>(col);
+                m_cols.emplace_back(encodeColumn(t.getRows(), col, tableDef[col], isSorted, begin, end));
+            }
+        }
+
+        auto numRows() const noexcept -> std::size_t { return m_numRows; }
+        auto getColumn(std::size_t col) const -> const encodedColumn_t & { return m_cols[col]; }
+
+        auto bytes() const -> std::size_t
+        {
+            std::size_t total = 0;
+            for (const auto &col : m_cols)
+                total += std::visit([](const auto &c)
+                                    { return c.bytes(); },
+                                    col);
+
+            return total;
+        }
+
+        auto getRow(std::size_t i) const -> row_t
+        {
+            row_t row;
+            row.reserve(m_cols.size());
+            for (const auto &col : m_cols)
+                row.emplace_back(std::visit([i](const auto &c)
+                                            { return colValue_t(c.at(i)); },
+                                            col));
+
+            return row;
+        }
+
+        /**
+         * @brief Calls onRange(begin, end) for every stretch of rows (indices within the chunk) satisfying the predicate
+         */
+        template <typename F>
+        auto forEachMatchingRange(const columnPredicate_t &pred, F &&onRange) const -> void
+        {
+            std::visit([&]<typename E>(const E &c)
+                       {
+                           using T = typename E::value_type;
+                           assert(std::holds_alternative<T>(pred.value));
+                           c.forEachMatchingRange(pred.op, std::get<T>(pred.value), onRange); },
+                       m_cols[pred.colIndex.get()]);
+        }
+
+    private:
+        template <typename T>
+        static auto appendAll(auto &encoded, const rows_t &rows, std::size_t col, std::size_t begin, std::size_t end) -> void
+        {
+            for (auto i = begin; i < end; ++i)
+                encoded.append(std::get<T>(rows[i][col]));
+        }
+
+        template <typename T>
+        static auto encodeAs(encoding_e e, const rows_t &rows, std::size_t col, std::size_t begin, std::size_t end) -> encodedColumn_t
+        {
+            if constexpr (std::is_same_v<T, int>)
+            {
+                if (e == encoding_e::FRAME_OF_REFERENCE)
+                {
+                    std::vector<int> values;
+                    values.reserve(end - begin);
+                    for (auto i = begin; i < end; ++i)
+                        values.push_back(std::get<int>(rows[i][col]));
+
+                    return forColumn_t(values);
+                }
+            }
+
+            if (e == encoding_e::RLE)
+            {
+                rleColumn_t<T> encoded;
+                appendAll<T>(encoded, rows, col, begin, end);
+                return encoded;
+            }
+
+            plainColumn_t<T> encoded;
+            appendAll<T>(encoded, rows, col, begin, end);
+            return encoded;
+        }
+
+        template <typename T>
+        static auto encodeTyped(const rows_t &rows, std::size_t col, colType_e ct, bool isSorted, std::size_t begin, std::size_t end) -> encodedColumn_t
+        {
+            const auto defaultEncoding = [ct]
+            {
+                switch (ct)
+                {
+                case colType_e::BOOLEAN:
+                case colType_e::COLOR:
+                    return encoding_e::RLE;
+                case colType_e::INTEGER:
+                    return encoding_e::FRAME_OF_REFERENCE;
+                case colType_e::STRING:
+                case colType_e::DOUBLE:
+                    return encoding_e::PLAIN;
+                }
+            }();
+
+            if (isSorted && defaultEncoding != encoding_e::RLE)
+            {
+                // Sorted means equal values are next to each other, but that only pays off if there are repeats
+                auto rle = encodeAs<T>(encoding_e::RLE, rows, col, begin, end);
+                if (std::get<rleColumn_t<T>>(rle).numRuns() * 2 <= end - begin)
+                    return rle;
+            }
+
+            return encodeAs<T>(defaultEncoding, rows, col, begin, end);
+        }
+
+        static auto encodeColumn(const rows_t &rows, std::size_t col, colType_e ct, bool isSorted, std::size_t begin, std::size_t end) -> encodedColumn_t
+        {
+            switch (ct)
+            {
+            case colType_e::INTEGER:
+                return encodeTyped<int>(rows, col, ct, isSorted, begin, end);
+            case colType_e::STRING:
+                return encodeTyped<std::string>(rows, col, ct, isSorted, begin, end);
+            case colType_e::BOOLEAN:
+                return encodeTyped<bool>(rows, col, ct, isSorted, begin, end);
+            case colType_e::DOUBLE:
+                return encodeTyped<double>(rows, col, ct, isSorted, begin, end);
+            case colType_e::COLOR:
+                return encodeTyped<Color>(rows, col, ct, isSorted, begin, end);
+            }
+        }
+
+        std::size_t m_numRows;
+        std::vector<encodedColumn_t> m_cols; // Parallel to the table definition
+    };
+
+    /**
+     * @brief Immutable, compressed snapshot of a table_t
+     *
+     *        Rows are split into chunks of chunkRows and every chunk picks its own encodings. Filters and
+     *        aggregates work on the encoded columns, getRow / toTable are there when actual rows are needed
+     */
+    class sealedTable_t
+    {
+    public:
+        explicit sealedTable_t(const table_t &t, std::size_t chunkRows = defaultChunkRows)
+            : m_tableDef(t.getTableDef()),
+              m_chunkRows(chunkRows)
+        {
+            assert(chunkRows > 0);
+
+            const auto numRows = t.getRows().size();
+            m_chunks.reserve((numRows + chunkRows - 1) / chunkRows);
+            for (std::size_t begin = 0; begin < numRows; begin += chunkRows)
+                m_chunks.emplace_back(t, begin, std::min(begin + chunkRows, numRows));
+        }
+
+        auto numRows() const noexcept -> std::size_t
+        {
+            return m_chunks.empty() ? 0 : (m_chunks.size() - 1) * m_chunkRows + m_chunks.back().numRows();
+        }
+
+        auto getTableDef() const noexcept -> const std::vector<colType_e> & { return m_tableDef; }
+        auto getChunks() const noexcept -> const std::vector<sealedChunk_t> & { return m_chunks; }
+
+        /**
+         * @brief Rough in-memory size of the encoded columns, to compare against the row representation
+         */
+        auto bytes() const -> std::size_t
+        {
+            std::size_t total = 0;
+            for (const auto &chunk : m_chunks)
+                total += chunk.bytes();
+
+            return total;
+        }
+
+        auto getRow(std::size_t i) const -> row_t { return m_chunks[i / m_chunkRows].getRow(i % m_chunkRows); }
+
+        auto toTable() const -> table_t
+        {
+            table_t t(m_tableDef);
+            for (std::size_t i = 0; i < numRows(); ++i)
+                t.appendRow(getRow(i));
+
+            return t;
+        }
+
+        /**
+         * @brief Indices of every row satisfying the predicate, in order
+         */
+        auto filter(const columnPredicate_t &pred) const -> std::vector<std::size_t>
+        {
+            assert(isPredicateValid(pred));
+
+            std::vector<std::size_t> matches;
+            for (std::size_t c = 0; c < m_chunks.size(); ++c)
+            {
+                const auto offset = c * m_chunkRows;
+                m_chunks[c].forEachMatchingRange(pred, [&matches, offset](std::size_t begin, std::size_t end)
+                                                 {
+                                                     const auto numMatches = matches.size();
+                                                     matches.resize(numMatches + end - begin);
+                                                     std::iota(matches.begin() + numMatches, matches.end(), offset + begin); });
+            }
+
+            return matches;
+        }
+
+        auto count(const columnPredicate_t &pred) const -> std::size_t
+        {
+            assert(isPredicateValid(pred));
+
+            std::size_t total = 0;
+            for (const auto &chunk : m_chunks)
+                chunk.forEachMatchingRange(pred, [&total](std::size_t begin, std::size_t end)
+                                           { total += end - begin; });
+
+            return total;
+        }
+
+        /**
+         * @brief Sum of an INTEGER or DOUBLE column
+         */
+        auto sum(colIndex_t colIndex) const -> double
+        {
+            assert(colIndex.get() < static_cast<int>(m_tableDef.size()));
+
+            double total = 0;
+            for (const auto &chunk : m_chunks)
+            {
+                total += std::visit([]<typename E>(const E &c) -> double
+                                    {
+                                        if constexpr (is_summable<typename E::value_type>)
+                                            return c.sum();
+
+                                        assert(false && "Column can't be summed");
+                                        return 0; },
+                                    chunk.getColumn(colIndex.get()));
+            }
+
+            return total;
+        }
+
+        auto min(colIndex_t colIndex) const -> std::optional<colValue_t> { return extreme(colIndex, std::weak_ordering::less); }
+        auto max(colIndex_t colIndex) const -> std::optional<colValue_t> { return extreme(colIndex, std::weak_ordering::greater); }
+
+    private:
+        auto extreme(colIndex_t colIndex, std::weak_ordering better) const -> std::optional<colValue_t>
+        {
+            assert(colIndex.get() < static_cast<int>(m_tableDef.size()));
+
+            const auto compare = getTypeSpecificComparisonFunc(m_tableDef[colIndex.get()]);
+
+            std::optional<colValue_t> best;
+            for (const auto &chunk : m_chunks)
+            {
+                auto candidate = std::visit([better](const auto &c)
+                                            { return colValue_t(better == std::weak_ordering::less ? c.min() : c.max()); },
+                                            chunk.getColumn(colIndex.get()));
+
+                if (!best.has_value() || compare.get()(candidate, best.value()) == better)
+                    best = std::move(candidate);
+            }
+
+            return best;
+        }
+
+        auto isPredicateValid(const columnPredicate_t &pred) const noexcept -> bool
+        {
+            if (pred.colIndex.get() >= static_cast<int>(m_tableDef.size()))
+                return false;
+
+            return pred.value.index() == static_cast<std::size_t>(m_tableDef[pred.colIndex.get()]);
+        }
+
+        std::vector<colType_e> m_tableDef;
+        std::size_t m_chunkRows;
+
+        std::vector<sealedChunk_t> m_chunks;
+    };
+}
+
+#endif // INCLUDE_SEALED_TABLE_H
@@ -45,17 +45,14 @@ namespace table
     }
 
     /**
-     * @brief Compares two column values, using spaceship operator if possible
+     * @brief Compares two values of the same column type, using spaceship operator if possible
      *
-     * @tparam T Underlying type in the variant
+     * @tparam T Column type
      * @return std::weak_ordering between values
      */
     template <ColumnType T>
-    static inline auto compareType(const colValue_t &lhs, const colValue_t &rhs) -> std::weak_ordering
+    static inline auto compareValues(const T &left, const T &right) -> std::weak_ordering
     {
-        const auto left = std::get<T>(lhs);
-        const auto right = std::get<T>(rhs);
-
         // This is the *clean* version but Apple clang doesn't currently implement this
         // https://en.cppreference.com/w/cpp/compiler_support/20#:~:text=19.29%20(16.10)*-,13.1.6*%20(partial),-constexpr%20default%20constructor
         // return std::std::compare_weak_order_fallback<T>(left, right);
@@ -67,6 +64,18 @@ namespace table
             return longCompare(left, right);
     }
 
+    /**
+     * @brief Compares two column values, using spaceship operator if possible
+     *
+     * @tparam T Underlying type in the variant
+     * @return std::weak_ordering between values
+     */
+    template <ColumnType T>
+    static inline auto compareType(const colValue_t &lhs, const colValue_t &rhs) -> std::weak_ordering
+    {
+        return compareValues<T>(std::get<T>(lhs), std::get<T>(rhs));
+    }
+
     /**
      * @brief Depending on the column type, return a different comparison function
      *
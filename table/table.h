@@ -1,12 +1,16 @@
 #ifndef INCLUDE_TABLE_H
 #define INCLUDE_TABLE_H
 
+#include <algorithm>
 #include <assert.h>
 #include <functional>
 #include <iterator>
+#include <numeric>
+#include <optional>
 
 #include "table_helpers.h"
 #include "sort_helpers.h"
+#include "zone_map.h"
 
 namespace table
 {
@@ -25,14 +29,18 @@ namespace table
          * @brief Construct a new table_t object
          *
          * @param tableDef Ordered container of types
+         * @param zoneRows How many rows each zone map covers
          */
         template <typename C = std::vector<colType_e>>
             requires std::is_constructible_v<std::vector<colType_e>, C>
-        table_t(C &&tableDef)
+        table_t(C &&tableDef, std::size_t zoneRows = defaultChunkRows)
             : m_tableDef(std::forward<C>(tableDef)),
               m_compareFuncs(),
-              m_rows()
+              m_rows(),
+              m_zones(zoneRows)
         {
+            assert(zoneRows > 0);
+
             // ASSUMPTION: Table definition is constant
             // Pre-define the comparison for each column since each column type is known
             m_compareFuncs.reserve(m_tableDef.size());
@@ -44,6 +52,7 @@ namespace table
         {
             assert(isRowValid(row));
             m_rows.emplace_back(std::move(row));
+            m_sortedBy.reset();
         }
 
         /**
@@ -56,6 +65,79 @@ namespace table
          */
         template <typename C = std::vector<sortPolicy_t>>
         auto sort(const C &sortPolicies) -> void
+        {
+            auto compare = makeRowComparator(sortPolicies);
+
+            // Once we have all our policy functions built, use the STL sort
+            // (unless the zone maps say the chunks can be dealt with one at a time)
+            if (!sortUsingZones(sortPolicies, compare))
+            {
+                std::sort(m_rows.begin(), m_rows.end(), compare);
+                m_zones.invalidate();
+            }
+
+            rememberSort(sortPolicies);
+        }
+
+        /**
+         * @brief Same result as sort(sortPolicies) but done in pieces so a caller can follow along
+         *
+         *        Sorts numChunks slices independently, then merges neighbouring slices until one is left.
+         *        onProgress(fraction done) is called between every step and may throw to abandon the sort,
+         *        in which case the row order is unspecified
+         *
+         * @param sortPolicies
+         * @param numChunks  How many slices to sort before merging, more means finer grained progress
+         * @param onProgress Callable taking a double in [0, 1]
+         */
+        template <typename C = std::vector<sortPolicy_t>, typename F>
+        auto sort(const C &sortPolicies, std::size_t numChunks, F &&onProgress) -> void
+        {
+            auto compare = makeRowComparator(sortPolicies);
+            m_sortedBy.reset();
+
+            numChunks = std::clamp<std::size_t>(numChunks, 1, std::max<std::size_t>(m_rows.size(), 1));
+            const auto chunkSize = (m_rows.size() + numChunks - 1) / numChunks;
+            const auto chunkBegin = [this](std::size_t rowIndex)
+            {
+                return m_rows.begin() + std::min(rowIndex, m_rows.size());
+            };
+
+            try
+            {
+                // Half the work is sorting the slices, the other half is merging them back together
+                for (std::size_t i = 0; i < numChunks; ++i)
+                {
+                    std::sort(chunkBegin(i * chunkSize), chunkBegin((i + 1) * chunkSize), compare);
+                    onProgress(0.5 * (i + 1) / numChunks);
+                }
+
+                for (auto width = chunkSize; width < m_rows.size(); width *= 2)
+                {
+                    for (std::size_t lo = 0; lo + width < m_rows.size(); lo += 2 * width)
+                        std::inplace_merge(chunkBegin(lo), chunkBegin(lo + width), chunkBegin(lo + 2 * width), compare);
+
+                    onProgress(0.5 + 0.5 * std::min(1.0, static_cast<double>(2 * width) / m_rows.size()));
+                }
+            }
+            catch (...)
+            {
+                // Whatever order the rows were left in, the zone maps no longer describe it
+                m_zones.invalidate();
+                throw;
+            }
+
+            m_zones.invalidate();
+            rememberSort(sortPolicies);
+        }
+
+        /**
+         * @brief Build the "is lhs less than rhs" operator for a set of sort policies
+         *
+         *  NOTE: The comparator refers back to this table, it shouldn't outlive it
+         */
+        template <typename C = std::vector<sortPolicy_t>>
+        auto makeRowComparator(const C &sortPolicies) const -> sortHelper_t
         {
             std::vector<policyFunc_f> sortPriorityFunctions;
             sortPriorityFunctions.reserve(sortPolicies.size());
@@ -64,7 +146,7 @@ namespace table
             for (const auto &policy : sortPolicies)
             {
                 assert(isSortPolicyValid(policy));
-                auto compareFunc = [this, &policy](const row_t &lhs, const row_t &rhs)
+                auto compareFunc = [this, policy](const row_t &lhs, const row_t &rhs)
                 {
                     auto &leftVal = lhs[policy.colIndex.get()];
                     auto &rightVal = rhs[policy.colIndex.get()];
@@ -82,14 +164,289 @@ namespace table
                 sortPriorityFunctions.emplace_back(std::move(compareFunc));
             }
 
-            // Once we have all our policy functions built, use the STL sort
-            std::sort(m_rows.begin(), m_rows.end(), sortHelper_t(std::move(sortPriorityFunctions)));
+            return sortHelper_t(std::move(sortPriorityFunctions));
         }
 
-        auto getRows() noexcept const -> const rows_t & { return m_rows; }
-        auto getTableDef() noexcept const -> const std::vector<colType_e> & { return m_tableDef; }
+        /**
+         * @brief Indices of every row satisfying all of the predicates, in order
+         *
+         *        Chunks whose zone maps rule out a match are skipped entirely, and predicates the zone map
+         *        says every row in a chunk satisfies aren't checked row by row
+         */
+        template <typename C = std::vector<columnPredicate_t>>
+        auto filter(const C &predicates) const -> std::vector<std::size_t>
+        {
+            std::vector<std::size_t> matches;
+            std::vector<const columnPredicate_t *> rowChecks;
+
+            const auto &zones = getZoneMaps();
+            for (std::size_t z = 0; z < zones.size(); ++z)
+            {
+                rowChecks.clear();
+
+                auto canMatch = true;
+                for (const auto &pred : predicates)
+                {
+                    assert(isPredicateValid(pred));
+                    auto zoneMatch = zones[z].getColumn(pred.colIndex).match(pred, m_compareFuncs[pred.colIndex.get()]);
+                    if (zoneMatch == zoneMatch_e::NONE)
+                    {
+                        canMatch = false;
+                        break;
+                    }
+
+                    if (zoneMatch == zoneMatch_e::SOME)
+                        rowChecks.push_back(&pred);
+                }
+
+                if (!canMatch)
+                    continue;
+
+                for (auto i = zoneRowsBegin(z); i < zoneRowsEnd(z); ++i)
+                {
+                    auto isMatch = std::all_of(rowChecks.begin(), rowChecks.end(), [this, i](const columnPredicate_t *pred)
+                                               {
+                                                   auto &compareFunc = m_compareFuncs[pred->colIndex.get()];
+                                                   return satisfies(compareFunc.get()(m_rows[i][pred->colIndex.get()], pred->value), pred->op); });
+                    if (isMatch)
+                        matches.push_back(i);
+                }
+            }
+
+            return matches;
+        }
+
+        /**
+         * @brief The first k rows the table would have if it were sorted by sortPolicies, without sorting it
+         *
+         *        Chunks are visited in the order their zone maps say they start in for the leading policy.
+         *        Once k rows are held and a chunk starts after the worst of them, that chunk and every one
+         *        after it can be skipped
+         */
+        template <typename C = std::vector<sortPolicy_t>>
+        auto topK(const C &sortPolicies, std::size_t k) const -> rows_t
+        {
+            if (k == 0 || std::begin(sortPolicies) == std::end(sortPolicies))
+                return rows_t(m_rows.begin(), m_rows.begin() + std::min(k, m_rows.size()));
+
+            auto compare = makeRowComparator(sortPolicies);
+            auto isBetter = [&compare](const row_t *lhs, const row_t *rhs)
+            {
+                return compare(*lhs, *rhs);
+            };
+
+            const auto &leading = *std::begin(sortPolicies);
+            const auto &leadingCompare = m_compareFuncs[leading.colIndex.get()];
+            const auto leadingZones = columnZones(leading.colIndex);
+            const auto zoneOrder = zonesInOrder(leadingZones, leading);
+
+            // Max-heap on "better", so the front is the worst row we are still holding on to
+            std::vector<const row_t *> best;
+            best.reserve(k + 1);
+
+            for (const auto z : zoneOrder)
+            {
+                if (best.size() == k)
+                {
+                    auto vsWorst = leadingCompare.get()(zoneStart(leadingZones[z], leading), (*best.front())[leading.colIndex.get()]);
+                    if (leading.sortOrder == sortOrder_e::DESC)
+                        vsWorst = flipOrdering(vsWorst);
+
+                    if (vsWorst > 0)
+                        break;
+                }
+
+                for (auto i = zoneRowsBegin(z); i < zoneRowsEnd(z); ++i)
+                {
+                    if (best.size() == k && !isBetter(&m_rows[i], best.front()))
+                        continue;
+
+                    best.push_back(&m_rows[i]);
+                    std::push_heap(best.begin(), best.end(), isBetter);
+
+                    if (best.size() > k)
+                    {
+                        std::pop_heap(best.begin(), best.end(), isBetter);
+                        best.pop_back();
+                    }
+                }
+            }
+
+            std::sort_heap(best.begin(), best.end(), isBetter);
+
+            rows_t top;
+            top.reserve(best.size());
+            for (const auto *row : best)
+                top.push_back(*row);
+
+            return top;
+        }
+
+        auto getRows() const noexcept -> const rows_t & { return m_rows; }
+        auto getTableDef() const noexcept -> const std::vector<colType_e> & { return m_tableDef; }
+
+        /**
+         * @brief Leading policy of the last sort, as long as no row has been appended since
+         */
+        auto getSortedBy() const noexcept -> const std::optional<sortPolicy_t> & { return m_sortedBy; }
+
+        /**
+         * @brief Statistics for each consecutive block of zoneRows rows, in row order
+         *
+         *        Built on first use and after anything that reorders the rows, appends just add to them
+         */
+        auto getZoneMaps() const -> const std::vector<zoneMap_t> & { return m_zones.get(m_rows, m_compareFuncs); }
+        auto getZoneRows() const noexcept -> std::size_t { return m_zones.zoneRows(); }
 
     private:
+        /**
+         * @brief Rows [zoneRowsBegin(z), zoneRowsEnd(z)) make up chunk z
+         */
+        auto zoneRowsBegin(std::size_t z) const noexcept -> std::size_t { return z * getZoneRows(); }
+        auto zoneRowsEnd(std::size_t z) const noexcept -> std::size_t { return std::min((z + 1) * getZoneRows(), m_rows.size()); }
+
+        /**
+         * @brief One column's statistics for each chunk
+         *
+         *        Copied out of the zone maps when they're up to date. Otherwise only that column gets looked at,
+         *        which is much cheaper than catching every column up right before a sort reorders the rows anyway
+         */
+        auto columnZones(colIndex_t colIndex) const -> std::vector<columnZone_t>
+        {
+            std::vector<columnZone_t> cols;
+            if (m_zones.isUpToDate(m_rows.size()))
+            {
+                for (const auto &zone : getZoneMaps())
+                    cols.push_back(zone.getColumn(colIndex));
+
+                return cols;
+            }
+
+            const auto &compareFunc = m_compareFuncs[colIndex.get()];
+            for (std::size_t i = 0; i < m_rows.size(); ++i)
+            {
+                const auto isFirstInZone = i % getZoneRows() == 0;
+                if (isFirstInZone)
+                    cols.emplace_back();
+
+                cols.back().update(m_rows[i][colIndex.get()], isFirstInZone ? nullptr : &m_rows[i - 1][colIndex.get()], compareFunc);
+            }
+
+            return cols;
+        }
+
+        /**
+         * @brief Where a chunk's values start / end when walking it in the policy's order
+         */
+        static auto zoneStart(const columnZone_t &zone, const sortPolicy_t &sp) -> const colValue_t &
+        {
+            return sp.sortOrder == sortOrder_e::ASC ? zone.min().value() : zone.max().value();
+        }
+
+        static auto zoneEnd(const columnZone_t &zone, const sortPolicy_t &sp) -> const colValue_t &
+        {
+            return sp.sortOrder == sortOrder_e::ASC ? zone.max().value() : zone.min().value();
+        }
+
+        /**
+         * @brief Chunk indices ordered by where they start for the policy
+         */
+        auto zonesInOrder(const std::vector<columnZone_t> &zones, const sortPolicy_t &sp) const -> std::vector<std::size_t>
+        {
+            const auto &compareFunc = m_compareFuncs[sp.colIndex.get()];
+
+            std::vector<std::size_t> zoneOrder(zones.size());
+            std::iota(zoneOrder.begin(), zoneOrder.end(), 0);
+            std::stable_sort(zoneOrder.begin(), zoneOrder.end(), [&](std::size_t lhs, std::size_t rhs)
+                             {
+                                 auto res = compareFunc.get()(zoneStart(zones[lhs], sp), zoneStart(zones[rhs], sp));
+                                 return sp.sortOrder == sortOrder_e::ASC ? res < 0 : res > 0; });
+
+            return zoneOrder;
+        }
+
+        /**
+         * @brief Sort without ever comparing rows from different chunks, if the zone maps allow it
+         *
+         *        When the chunks' ranges on the leading column don't overlap, putting the chunks in order and
+         *        sorting each one by itself is a full sort. A chunk already in order needs no work at all
+         *        as long as there's no tie breaking policy to worry about
+         *
+         * @return false if the ranges overlap and the table still needs sorting
+         */
+        template <typename C>
+        auto sortUsingZones(const C &sortPolicies, sortHelper_t &compare) -> bool
+        {
+            if (m_rows.empty() || std::begin(sortPolicies) == std::end(sortPolicies))
+                return false;
+
+            const sortPolicy_t leading = *std::begin(sortPolicies);
+            const auto hasTieBreaks = std::next(std::begin(sortPolicies)) != std::end(sortPolicies);
+            const auto &leadingCompare = m_compareFuncs[leading.colIndex.get()];
+            const auto leadingZones = columnZones(leading.colIndex);
+
+            const auto zoneOrder = zonesInOrder(leadingZones, leading);
+            for (std::size_t i = 1; i < zoneOrder.size(); ++i)
+            {
+                auto gap = leadingCompare.get()(zoneEnd(leadingZones[zoneOrder[i - 1]], leading), zoneStart(leadingZones[zoneOrder[i]], leading));
+                if (leading.sortOrder == sortOrder_e::DESC)
+                    gap = flipOrdering(gap);
+
+                // With tie breaks, an equal leading value on both sides of a boundary would still need comparing
+                if (gap > 0 || (hasTieBreaks && gap == 0))
+                    return false;
+            }
+
+            auto isMoved = !std::is_sorted(zoneOrder.begin(), zoneOrder.end());
+            std::vector<std::pair<std::size_t, std::size_t>> ranges; // New [begin, end) of each chunk
+            std::vector<bool> needsSort;
+
+            rows_t reordered;
+            if (isMoved)
+                reordered.reserve(m_rows.size());
+
+            std::size_t begin = 0;
+            for (const auto z : zoneOrder)
+            {
+                const auto numRows = zoneRowsEnd(z) - zoneRowsBegin(z);
+                ranges.emplace_back(begin, begin + numRows);
+                needsSort.push_back(hasTieBreaks || !leadingZones[z].isSorted(leading.sortOrder));
+                begin += numRows;
+
+                if (isMoved)
+                {
+                    auto chunkBegin = m_rows.begin() + zoneRowsBegin(z);
+                    std::move(chunkBegin, chunkBegin + numRows, std::back_inserter(reordered));
+                }
+            }
+
+            if (isMoved)
+                m_rows = std::move(reordered);
+
+            auto isChanged = isMoved;
+            for (std::size_t i = 0; i < ranges.size(); ++i)
+            {
+                if (!needsSort[i])
+                    continue;
+
+                std::sort(m_rows.begin() + ranges[i].first, m_rows.begin() + ranges[i].second, compare);
+                isChanged = true;
+            }
+
+            if (isChanged)
+                m_zones.invalidate();
+
+            return true;
+        }
+
+        template <typename C>
+        auto rememberSort(const C &sortPolicies) -> void
+        {
+            m_sortedBy.reset();
+            if (std::begin(sortPolicies) != std::end(sortPolicies))
+                m_sortedBy = *std::begin(sortPolicies);
+        }
+
         inline auto isRowValid(const row_t &row) noexcept -> bool
         {
             // Correct # of elements
@@ -107,16 +464,28 @@ namespace table
             return true;
         }
 
-        inline auto isSortPolicyValid(const sortPolicy_t &sp) noexcept -> bool
+        inline auto isSortPolicyValid(const sortPolicy_t &sp) const noexcept -> bool
         {
             // Valid column index
             return sp.colIndex.get() < m_tableDef.size();
         }
 
+        inline auto isPredicateValid(const columnPredicate_t &pred) const noexcept -> bool
+        {
+            if (pred.colIndex.get() >= static_cast<int>(m_tableDef.size()))
+                return false;
+
+            // Same enum <-> variant index hack as isRowValid
+            return pred.value.index() == static_cast<std::size_t>(m_tableDef[pred.colIndex.get()]);
+        }
+
         std::vector<colType_e> m_tableDef;         // Represents the columns and their types
         std::vector<compareFunc_f> m_compareFuncs; // Parallel to m_tableDef, for each column, what compare func should it use
 
-        rows_t m_rows; // Holds the rows of the table
+        rows_t m_rows;                          // Holds the rows of the table
+        std::optional<sortPolicy_t> m_sortedBy; // Which column m_rows is currently ordered on, if any
+
+        lazyZoneMaps_t m_zones; // Statistics for consecutive blocks of rows, only kept up to date on demand
     };
 }
 
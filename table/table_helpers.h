@@ -1,6 +1,7 @@
 #ifndef INCLUDE_TABLE_HELPERS_H
 #define INCLUDE_TABLE_HELPERS_H
 
+#include <array>
 #include <iostream>
 #include <variant>
 #include <vector>
@@ -56,8 +57,46 @@ namespace table
 
     using colValue_t = std::variant<int, std::string, bool, double, Color>;
     using row_t = std::vector<colValue_t>;
+
+    /**
+     * @brief Position of T within a variant's alternatives, sizeof...(Us) if it isn't one
+     */
+    template <typename T, typename V>
+    struct variantIndex;
+
+    template <typename T, typename... Us>
+    struct variantIndex<T, std::variant<Us...>>
+    {
+        static constexpr std::size_t value = []
+        {
+            constexpr std::array<bool, sizeof...(Us)> matches{std::is_same_v<T, Us>...};
+            for (std::size_t i = 0; i < matches.size(); ++i)
+            {
+                if (matches[i])
+                    return i;
+            }
+            return matches.size();
+        }();
+    };
+
+    /**
+     * @brief A column type that can also live inside of a dynamic table (i.e. it's part of colValue_t)
+     */
+    template <typename T>
+    concept ColumnValue = ColumnType<T> && (variantIndex<T, colValue_t>::value < std::variant_size_v<colValue_t>);
+
+    /**
+     * @brief Compile time mapping from a C++ type to its column type
+     *
+     *  NOTE: Relies on the same enum <-> variant index hack as table_t::isRowValid
+     */
+    template <ColumnValue T>
+    inline constexpr colType_e colTypeOf = static_cast<colType_e>(variantIndex<T, colValue_t>::value);
+
     using rows_t = std::vector<row_t>;
 
+    static constexpr std::size_t defaultChunkRows = 1 << 16; // Rows per chunk wherever a table is split into chunks
+
     /**
      * @brief Prints out every value in a row to std::cout
      */
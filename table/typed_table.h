@@ -0,0 +1,177 @@
+#ifndef INCLUDE_TYPED_TABLE_H
+#define INCLUDE_TYPED_TABLE_H
+
+#include <algorithm>
+#include <assert.h>
+#include <numeric>
+#include <tuple>
+
+#include "table.h"
+
+namespace table
+{
+    /**
+     * @brief Compile time version of sortPolicy_t, usable as a template argument
+     */
+    struct staticSortPolicy_t
+    {
+        std::size_t colIndex;  // Which column, relative to the table, should we sort on
+        sortOrder_e sortOrder; // Should we sort in ascending order (If not, sort in descending order)
+    };
+
+    /**
+     * @brief Table whose schema is known at compile time
+     *
+     *        Every column is its own std::vector<T> so there is no variant to inspect and no std::function
+     *        to call through when sorting. The comparator is stamped out by the compiler from the policy list
+     *
+     * @tparam Ts Column types, in order
+     */
+    template <ColumnType... Ts>
+        requires(sizeof...(Ts) > 0)
+    class typed_table_t
+    {
+    public:
+        static constexpr std::size_t numCols = sizeof...(Ts);
+
+        typed_table_t() = default;
+
+        /**
+         * @brief Copy the rows of a dynamic table into a typed table with the same definition
+         */
+        explicit typed_table_t(const table_t &t)
+            requires(ColumnValue<Ts> && ...)
+        {
+            assert(std::ranges::equal(t.getTableDef(), tableDef()));
+
+            const auto &rows = t.getRows();
+            reserve(rows.size());
+            for (const auto &row : rows)
+                appendFromRow(row, std::index_sequence_for<Ts...>{});
+        }
+
+        auto appendRow(Ts... values) -> void
+        {
+            appendValues(std::index_sequence_for<Ts...>{}, std::move(values)...);
+        }
+
+        auto reserve(std::size_t numRows) -> void
+        {
+            std::apply([numRows](auto &...cols)
+                       { (cols.reserve(numRows), ...); },
+                       m_cols);
+        }
+
+        /**
+         * @brief Sorts the table based on the compile time policies
+         *
+         *        We sort a permutation of row indices rather than the columns themselves (they aren't
+         *        stored together) and then shuffle every column by that permutation once
+         *
+         * @tparam Policies In order, how rows should be compared
+         */
+        template <staticSortPolicy_t... Policies>
+        auto sort() -> void
+        {
+            static_assert(((Policies.colIndex < numCols) && ...), "Sort policy column index out of range");
+
+            std::vector<std::size_t> perm(size());
+            std::iota(perm.begin(), perm.end(), 0);
+
+            std::sort(perm.begin(), perm.end(), [this](std::size_t lhs, std::size_t rhs)
+                      {
+                          // Go through as many policies as we have before we find a non-equivalent weak ordering
+                          auto compareResult = std::weak_ordering::equivalent;
+                          ((compareResult = comparePolicy<Policies>(lhs, rhs), compareResult != std::weak_ordering::equivalent) || ...);
+
+                          return compareResult == std::weak_ordering::less; });
+
+            applyPermutation(perm);
+        }
+
+        /**
+         * @brief Copy the rows back out into a dynamic table
+         */
+        auto toTable() const -> table_t
+            requires(ColumnValue<Ts> && ...)
+        {
+            constexpr auto def = tableDef();
+            table_t t(std::vector<colType_e>(def.begin(), def.end()));
+            for (std::size_t i = 0; i < size(); ++i)
+                t.appendRow(getDynamicRow(i, std::index_sequence_for<Ts...>{}));
+
+            return t;
+        }
+
+        static constexpr auto tableDef() noexcept -> std::array<colType_e, numCols>
+            requires(ColumnValue<Ts> && ...)
+        {
+            return {colTypeOf<Ts>...};
+        }
+
+        template <std::size_t I>
+        auto getColumn() const noexcept -> const auto & { return std::get<I>(m_cols); }
+
+        auto getRow(std::size_t i) const -> std::tuple<typename std::vector<Ts>::const_reference...>
+        {
+            return std::apply([i](const auto &...cols)
+                              { return std::tuple<typename std::vector<Ts>::const_reference...>(cols[i]...); },
+                              m_cols);
+        }
+
+        auto size() const noexcept -> std::size_t { return std::get<0>(m_cols).size(); }
+
+    private:
+        template <std::size_t... Is>
+        auto appendValues(std::index_sequence<Is...>, Ts &&...values) -> void
+        {
+            (std::get<Is>(m_cols).emplace_back(std::move(values)), ...);
+        }
+
+        template <std::size_t... Is>
+        auto appendFromRow(const row_t &row, std::index_sequence<Is...>) -> void
+        {
+            (std::get<Is>(m_cols).emplace_back(std::get<Ts>(row[Is])), ...);
+        }
+
+        template <std::size_t... Is>
+        auto getDynamicRow(std::size_t i, std::index_sequence<Is...>) const -> row_t
+        {
+            return row_t{colValue_t(std::get<Is>(m_cols)[i])...};
+        }
+
+        template <staticSortPolicy_t Policy>
+        auto comparePolicy(std::size_t lhs, std::size_t rhs) const -> std::weak_ordering
+        {
+            const auto &col = std::get<Policy.colIndex>(m_cols);
+
+            if constexpr (Policy.sortOrder == sortOrder_e::DESC)
+                return compareValues(col[rhs], col[lhs]);
+            else
+                return compareValues(col[lhs], col[rhs]);
+        }
+
+        auto applyPermutation(const std::vector<std::size_t> &perm) -> void
+        {
+            std::apply([&perm](auto &...cols)
+                       { (permuteColumn(cols, perm), ...); },
+                       m_cols);
+        }
+
+        template <typename T>
+        static auto permuteColumn(std::vector<T> &col, const std::vector<std::size_t> &perm) -> void
+        {
+            // Not every column type is default constructible (Color) so build up a fresh vector
+            std::vector<T> sorted;
+            sorted.reserve(col.size());
+            for (const auto i : perm)
+                sorted.emplace_back(std::move(col[i]));
+
+            col = std::move(sorted);
+        }
+
+        std::tuple<std::vector<Ts>...> m_cols; // One vector per column, all the same length
+    };
+}
+
+#endif // INCLUDE_TYPED_TABLE_H
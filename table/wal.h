@@ -0,0 +1,546 @@
+#ifndef INCLUDE_WAL_H
+#define INCLUDE_WAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "table_helpers.h"
+
+namespace table
+{
+    using lsn_t = uint64_t; // Log sequence number, every appended row gets the next one
+
+    /**
+     * @brief Binary layout of rows on disk
+     *
+     *        File:   [magic][baseLsn: u64][numCols: u32][colType: u8 ...] followed by records
+     *        Record: [payloadSize: u32][checksum: u32][lsn: u64][payload]
+     *        Values are written in native byte order, strings are [size: u32][bytes]
+     *
+     *        A record that is cut short or fails its checksum marks the end of the file, that's what
+     *        a crash in the middle of a write looks like
+     */
+    namespace wal
+    {
+        static constexpr char magic[8] = {'M', 'D', 'B', 'W', 'A', 'L', '0', '1'};
+        static constexpr std::size_t recordHeaderSize = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(lsn_t);
+
+        template <typename T>
+        static inline auto writePod(std::string &out, const T &value) -> void
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        static inline auto readPod(const char *&p, const char *end) -> std::optional<T>
+        {
+            if (static_cast<std::size_t>(end - p) < sizeof(T))
+                return std::nullopt;
+
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+
+        /**
+         * @brief FNV-1a, only meant to catch torn writes, not to be cryptographically anything
+         */
+        static inline auto checksum(const char *data, std::size_t size) noexcept -> uint32_t
+        {
+            uint32_t hash = 2166136261u;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 16777619u;
+            }
+
+            return hash;
+        }
+
+        static inline auto writeHeader(std::string &out, lsn_t baseLsn, const std::vector<colType_e> &tableDef) -> void
+        {
+            out.append(magic, sizeof(magic));
+            writePod(out, baseLsn);
+            writePod(out, static_cast<uint32_t>(tableDef.size()));
+            for (const auto colType : tableDef)
+                writePod(out, colType);
+        }
+
+        static inline auto writeValue(std::string &out, const colValue_t &value) -> void
+        {
+            std::visit([&out]<typename T>(const T &v)
+                       {
+                           if constexpr (std::is_same_v<T, std::string>)
+                           {
+                               writePod(out, static_cast<uint32_t>(v.size()));
+                               out.append(v);
+                           }
+                           else if constexpr (std::is_same_v<T, Color>)
+                               writePod(out, v.get());
+                           else
+                               writePod(out, v); },
+                       value);
+        }
+
+        /**
+         * @brief Append one record holding the whole row to out
+         */
+        static inline auto writeRecord(std::string &out, lsn_t lsn, const row_t &row) -> void
+        {
+            const auto recordBegin = out.size();
+            out.resize(recordBegin + recordHeaderSize);
+            std::memcpy(out.data() + recordBegin + 2 * sizeof(uint32_t), &lsn, sizeof(lsn));
+
+            for (const auto &value : row)
+                writeValue(out, value);
+
+            // Now that we know how big the payload is, fill in the rest of the header
+            const uint32_t payloadSize = out.size() - recordBegin - recordHeaderSize;
+            const auto crc = checksum(out.data() + recordBegin + 2 * sizeof(uint32_t), sizeof(lsn) + payloadSize);
+            std::memcpy(out.data() + recordBegin, &payloadSize, sizeof(payloadSize));
+            std::memcpy(out.data() + recordBegin + sizeof(uint32_t), &crc, sizeof(crc));
+        }
+
+        static inline auto readValue(colType_e ct, const char *&p, const char *end) -> std::optional<colValue_t>
+        {
+            switch (ct)
+            {
+            case colType_e::INTEGER:
+                return readPod<int>(p, end);
+            case colType_e::STRING:
+            {
+                auto size = readPod<uint32_t>(p, end);
+                if (!size.has_value() || static_cast<std::size_t>(end - p) < size.value())
+                    return std::nullopt;
+
+                std::string s(p, size.value());
+                p += size.value();
+                return s;
+            }
+            case colType_e::BOOLEAN:
+                return readPod<bool>(p, end);
+            case colType_e::DOUBLE:
+                return readPod<double>(p, end);
+            case colType_e::COLOR:
+            {
+                auto c = readPod<color_e>(p, end);
+                if (!c.has_value())
+                    return std::nullopt;
+
+                return Color(c.value());
+            }
+            }
+        }
+
+        /**
+         * @brief Contents of a log (or checkpoint) file, up to the first record that isn't intact
+         */
+        struct logContents_t
+        {
+            lsn_t baseLsn;
+            std::vector<colType_e> tableDef;
+            std::vector<std::pair<lsn_t, row_t>> records;
+            std::size_t validBytes; // Everything past this is a torn write and can be thrown away
+        };
+
+        static inline auto readFile(const std::string &path) -> std::optional<logContents_t>
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+                return std::nullopt;
+
+            const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            const char *p = data.data();
+            const char *end = p + data.size();
+
+            if (data.size() < sizeof(magic) || std::memcmp(p, magic, sizeof(magic)) != 0)
+                throw std::runtime_error(path + " is not a table log");
+            p += sizeof(magic);
+
+            logContents_t contents;
+            auto baseLsn = readPod<lsn_t>(p, end);
+            auto numCols = readPod<uint32_t>(p, end);
+            if (!baseLsn.has_value() || !numCols.has_value())
+                throw std::runtime_error(path + " has a truncated header");
+
+            contents.baseLsn = baseLsn.value();
+            for (uint32_t i = 0; i < numCols.value(); ++i)
+            {
+                auto colType = readPod<colType_e>(p, end);
+                if (!colType.has_value())
+                    throw std::runtime_error(path + " has a truncated header");
+
+                contents.tableDef.push_back(colType.value());
+            }
+
+            while (true)
+            {
+                contents.validBytes = p - data.data();
+
+                auto recordStart = p;
+                auto payloadSize = readPod<uint32_t>(p, end);
+                auto crc = readPod<uint32_t>(p, end);
+                if (!payloadSize.has_value() || !crc.has_value() ||
+                    static_cast<std::size_t>(end - p) < sizeof(lsn_t) + payloadSize.value())
+                    break;
+
+                if (checksum(p, sizeof(lsn_t) + payloadSize.value()) != crc.value())
+                    break;
+
+                auto lsn = readPod<lsn_t>(p, end).value();
+                const auto payloadEnd = p + payloadSize.value();
+
+                row_t row;
+                row.reserve(contents.tableDef.size());
+                for (const auto colType : contents.tableDef)
+                {
+                    auto value = readValue(colType, p, payloadEnd);
+                    if (!value.has_value())
+                        break;
+
+                    row.emplace_back(std::move(value.value()));
+                }
+
+                if (row.size() != contents.tableDef.size() || p != payloadEnd)
+                {
+                    p = recordStart;
+                    break;
+                }
+
+                contents.records.emplace_back(lsn, std::move(row));
+            }
+
+            return contents;
+        }
+
+        /**
+         * @brief Throw unless the file at path was written for a table with this definition
+         */
+        static inline auto checkTableDef(const logContents_t &contents, const std::vector<colType_e> &tableDef, const std::string &path) -> void
+        {
+            if (contents.tableDef != tableDef)
+                throw std::runtime_error(path + " was written for a different table definition");
+        }
+
+        /**
+         * @brief Does path hold a log that was created but never got its whole header written
+         *
+         *        Creating the file and writing its header can't happen atomically, a crash in between leaves
+         *        an empty file or the first few bytes of the header. Logs always start at baseLsn 0, so the
+         *        header they were meant to have is known up front
+         */
+        static inline auto hasTornHeader(const std::string &path, const std::vector<colType_e> &tableDef) -> bool
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+                return false;
+
+            std::string header;
+            writeHeader(header, 0, tableDef);
+
+            const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            return data.size() < header.size() && header.compare(0, data.size(), data) == 0;
+        }
+
+        [[noreturn]] static inline auto throwErrno(const std::string &what) -> void
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        static inline auto writeAll(int fd, const char *data, std::size_t size) -> void
+        {
+            while (size > 0)
+            {
+                auto written = ::write(fd, data, size);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    throwErrno("write");
+                }
+
+                data += written;
+                size -= written;
+            }
+        }
+
+        /**
+         * @brief A newly created or renamed file isn't durable until its directory entry is
+         */
+        static inline auto syncParentDirectory(const std::string &path) -> void
+        {
+            auto dir = std::filesystem::path(path).parent_path();
+            if (dir.empty())
+                dir = ".";
+
+            auto fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+                throwErrno("open " + dir.string());
+
+            auto res = ::fsync(fd);
+            ::close(fd);
+            if (res != 0)
+                throwErrno("fsync " + dir.string());
+        }
+    }
+
+    /**
+     * @brief How long appends may wait around to share an fsync with other appends
+     *
+     *        A bigger delay means fewer, larger fsyncs (throughput), a smaller one means appends
+     *        become durable sooner (latency)
+     */
+    struct groupCommitConfig_t
+    {
+        std::chrono::microseconds maxDelay{1000}; // Flush at the latest this long after the first buffered record
+        std::size_t maxBatchBytes = 1 << 20;      // Flush right away once this much is buffered
+    };
+
+    /**
+     * @brief Append only log of rows with a background flusher doing group commit
+     *
+     *        append() only serializes into an in-memory buffer. A flusher thread writes out and fsyncs
+     *        whatever has accumulated, so many appends pay for a single fsync
+     */
+    class writeAheadLog_t
+    {
+    public:
+        /**
+         * @brief Open (or create) the log at path for appending
+         *
+         * @param validBytes If the file already exists, how much of it is intact. Anything after is cut off.
+         *                   Without it the log starts over from an empty file
+         * @param nextLsn    LSN handed to the next appended row
+         */
+        writeAheadLog_t(std::string path,
+                        const std::vector<colType_e> &tableDef,
+                        groupCommitConfig_t config,
+                        std::optional<std::size_t> validBytes,
+                        lsn_t nextLsn)
+            : m_path(std::move(path)),
+              m_config(config),
+              m_nextLsn(nextLsn),
+              m_durableLsn(nextLsn - 1)
+        {
+            m_fd = ::open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (m_fd < 0)
+                wal::throwErrno("open " + m_path);
+
+            std::string header;
+            wal::writeHeader(header, 0, tableDef);
+            m_headerSize = header.size();
+
+            if (validBytes.has_value())
+            {
+                if (::ftruncate(m_fd, validBytes.value()) != 0)
+                    wal::throwErrno("ftruncate " + m_path);
+            }
+            else
+            {
+                // Either there was no file or all it holds is a torn header
+                if (::ftruncate(m_fd, 0) != 0)
+                    wal::throwErrno("ftruncate " + m_path);
+
+                wal::writeAll(m_fd, header.data(), header.size());
+            }
+
+            if (::fsync(m_fd) != 0)
+                wal::throwErrno("fsync " + m_path);
+
+            if (!validBytes.has_value())
+                wal::syncParentDirectory(m_path);
+
+            m_flusher = std::thread([this]
+                                    { flusherLoop(); });
+        }
+
+        ~writeAheadLog_t()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+            }
+            m_flushCv.notify_all();
+            m_flusher.join();
+
+            ::close(m_fd);
+        }
+
+        /**
+         * @brief Buffer a row to be written out, returns the LSN to wait on for it to be durable
+         *
+         *  NOTE: Once a write has failed the log is done for, this rethrows that failure instead of buffering
+         */
+        auto append(const row_t &row) -> lsn_t
+        {
+            std::unique_lock lock(m_mutex);
+            if (m_error != nullptr)
+                std::rethrow_exception(m_error);
+
+            const auto wasEmpty = m_buffer.empty();
+            if (wasEmpty)
+                m_oldestBuffered = std::chrono::steady_clock::now();
+
+            const auto lsn = m_nextLsn++;
+            wal::writeRecord(m_buffer, lsn, row);
+
+            // The flusher only needs a nudge to start its timer, or when the batch is already big enough
+            if (wasEmpty || m_buffer.size() >= m_config.maxBatchBytes)
+                m_flushCv.notify_one();
+
+            return lsn;
+        }
+
+        /**
+         * @brief Block until every row up to and including lsn has been fsync'd
+         */
+        auto waitDurable(lsn_t lsn) -> void
+        {
+            std::unique_lock lock(m_mutex);
+            m_durableCv.wait(lock, [this, lsn]
+                             { return m_durableLsn >= lsn || m_error != nullptr; });
+
+            if (m_error != nullptr)
+                std::rethrow_exception(m_error);
+        }
+
+        /**
+         * @brief Write out and fsync everything appended so far without waiting for the batch to fill up
+         */
+        auto flush() -> void
+        {
+            lsn_t lastLsn;
+            {
+                std::lock_guard lock(m_mutex);
+                lastLsn = m_nextLsn - 1;
+                m_flushRequested = true;
+            }
+            m_flushCv.notify_one();
+
+            waitDurable(lastLsn);
+        }
+
+        /**
+         * @brief Throw away every record, the caller has made sure they live on somewhere else (a checkpoint)
+         *
+         *  NOTE: Flushes first. LSNs keep counting up from where they were.
+         *        Nothing may be appended while this runs
+         */
+        auto truncate() -> void
+        {
+            flush();
+
+            std::lock_guard lock(m_mutex);
+            if (::ftruncate(m_fd, m_headerSize) != 0 || ::fsync(m_fd) != 0)
+                wal::throwErrno("truncate " + m_path);
+        }
+
+        auto lastLsn() const -> lsn_t
+        {
+            std::lock_guard lock(m_mutex);
+            return m_nextLsn - 1;
+        }
+
+    private:
+        // Prevent copying
+        writeAheadLog_t(const writeAheadLog_t &) = delete;
+        writeAheadLog_t &operator=(const writeAheadLog_t &) = delete;
+
+        // Prevent moving
+        writeAheadLog_t(writeAheadLog_t &&) = delete;
+        writeAheadLog_t &operator=(writeAheadLog_t &&) = delete;
+
+        auto flusherLoop() -> void
+        {
+            std::string batch;
+            std::unique_lock lock(m_mutex);
+
+            while (true)
+            {
+                if (m_buffer.empty())
+                {
+                    if (m_stopping)
+                        return;
+
+                    m_flushRequested = false;
+                    m_flushCv.wait(lock);
+                    continue;
+                }
+
+                // Give other appends a chance to join this batch, unless we've been told not to wait
+                const auto deadline = m_oldestBuffered + m_config.maxDelay;
+                m_flushCv.wait_until(lock, deadline, [this]
+                                     { return m_stopping || m_flushRequested || m_buffer.size() >= m_config.maxBatchBytes; });
+
+                batch.swap(m_buffer);
+                m_buffer.clear();
+                m_flushRequested = false;
+                const auto batchLsn = m_nextLsn - 1;
+
+                // Do the slow part without holding up appends
+                lock.unlock();
+                std::exception_ptr error;
+                try
+                {
+                    wal::writeAll(m_fd, batch.data(), batch.size());
+                    if (::fdatasync(m_fd) != 0)
+                        wal::throwErrno("fdatasync " + m_path);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                batch.clear();
+                lock.lock();
+
+                if (error != nullptr)
+                {
+                    // Replay stops at the failed batch, so nothing written after it could ever be read back.
+                    // Drop whatever piled up meanwhile and stop, append() refuses anything new from here on
+                    m_error = error;
+                    m_buffer.clear();
+                    m_durableCv.notify_all();
+                    return;
+                }
+
+                m_durableLsn = batchLsn;
+                m_durableCv.notify_all();
+            }
+        }
+
+        std::string m_path;
+        groupCommitConfig_t m_config;
+        int m_fd = -1;
+        std::size_t m_headerSize = 0;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_flushCv;   // Wakes the flusher
+        std::condition_variable m_durableCv; // Wakes anyone waiting for their LSN to hit disk
+
+        std::string m_buffer; // Serialized records not yet handed to the flusher
+        std::chrono::steady_clock::time_point m_oldestBuffered;
+        bool m_flushRequested = false;
+        bool m_stopping = false;
+        std::exception_ptr m_error; // Set once a write fails, every later append or wait rethrows it
+
+        lsn_t m_nextLsn;
+        lsn_t m_durableLsn;
+
+        std::thread m_flusher;
+    };
+}
+
+#endif // INCLUDE_WAL_H
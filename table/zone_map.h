@@ -0,0 +1,261 @@
+#ifndef INCLUDE_ZONE_MAP_H
+#define INCLUDE_ZONE_MAP_H
+
+#include <bitset>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "predicate.h"
+
+namespace table
+{
+    /**
+     * @brief Hash of any column value, Color included
+     */
+    static inline auto hashValue(const colValue_t &value) -> std::size_t
+    {
+        return std::visit([]<typename T>(const T &v) -> std::size_t
+                          {
+                              if constexpr (std::is_same_v<T, Color>)
+                                  return std::hash<uint8_t>{}(static_cast<uint8_t>(v.get()));
+                              else
+                                  return std::hash<T>{}(v); },
+                          value);
+    }
+
+    /**
+     * @brief Can any / every row in a chunk satisfy a predicate, going by its zone map alone
+     */
+    enum class zoneMatch_e : uint8_t
+    {
+        NONE,
+        SOME,
+        ALL
+    };
+
+    /**
+     * @brief Statistics about a single column within a chunk of rows
+     */
+    class columnZone_t
+    {
+    public:
+        /**
+         * @param previous Value in the row right before this one, if that row is in the same chunk
+         */
+        auto update(const colValue_t &value, const colValue_t *previous, const compareFunc_f &compare) -> void
+        {
+            if (!m_min.has_value())
+            {
+                m_min = value;
+                m_max = value;
+            }
+            else
+            {
+                // Compare against the previous value to keep track of whether the chunk is still in order
+                const auto vsLast = compare.get()(value, *previous);
+                m_nonDecreasing = m_nonDecreasing && vsLast >= 0;
+                m_nonIncreasing = m_nonIncreasing && vsLast <= 0;
+
+                if (compare.get()(value, m_min.value()) < 0)
+                    m_min = value;
+                if (compare.get()(value, m_max.value()) > 0)
+                    m_max = value;
+            }
+
+            m_seenHashes.set(hashValue(value) % m_seenHashes.size());
+        }
+
+        auto min() const noexcept -> const std::optional<colValue_t> & { return m_min; }
+        auto max() const noexcept -> const std::optional<colValue_t> & { return m_max; }
+
+        /**
+         * @brief Is the column already in order (for the given direction) within the chunk
+         */
+        auto isSorted(sortOrder_e so) const noexcept -> bool
+        {
+            return so == sortOrder_e::ASC ? m_nonDecreasing : m_nonIncreasing;
+        }
+
+        /**
+         * @brief Linear counting estimate of the number of distinct values, good to a few percent
+         *        until the number of distinct values gets close to the sketch size
+         */
+        auto distinctEstimate() const -> double
+        {
+            const auto bits = static_cast<double>(m_seenHashes.size());
+            const auto unset = static_cast<double>(m_seenHashes.size() - m_seenHashes.count());
+            if (unset == 0)
+                return bits;
+
+            return -bits * std::log(unset / bits);
+        }
+
+        auto match(const columnPredicate_t &pred, const compareFunc_f &compare) const -> zoneMatch_e
+        {
+            if (!m_min.has_value())
+                return zoneMatch_e::NONE;
+
+            const auto minVsValue = compare.get()(m_min.value(), pred.value);
+            const auto maxVsValue = compare.get()(m_max.value(), pred.value);
+
+            // Every value in the chunk sits in [min, max], so checking the bounds covers everything in between
+            switch (pred.op)
+            {
+            case compareOp_e::EQ:
+                if (minVsValue > 0 || maxVsValue < 0)
+                    return zoneMatch_e::NONE;
+                return minVsValue == 0 && maxVsValue == 0 ? zoneMatch_e::ALL : zoneMatch_e::SOME;
+            case compareOp_e::NE:
+                if (minVsValue == 0 && maxVsValue == 0)
+                    return zoneMatch_e::NONE;
+                return minVsValue > 0 || maxVsValue < 0 ? zoneMatch_e::ALL : zoneMatch_e::SOME;
+            case compareOp_e::LT:
+            case compareOp_e::LE:
+                if (!satisfies(minVsValue, pred.op))
+                    return zoneMatch_e::NONE;
+                return satisfies(maxVsValue, pred.op) ? zoneMatch_e::ALL : zoneMatch_e::SOME;
+            case compareOp_e::GT:
+            case compareOp_e::GE:
+                if (!satisfies(maxVsValue, pred.op))
+                    return zoneMatch_e::NONE;
+                return satisfies(minVsValue, pred.op) ? zoneMatch_e::ALL : zoneMatch_e::SOME;
+            }
+        }
+
+    private:
+        std::optional<colValue_t> m_min;
+        std::optional<colValue_t> m_max;
+
+        bool m_nonDecreasing = true;
+        bool m_nonIncreasing = true;
+
+        std::bitset<1024> m_seenHashes; // Sketch for distinctEstimate()
+    };
+
+    /**
+     * @brief Statistics for every column over a contiguous chunk of a table's rows
+     */
+    class zoneMap_t
+    {
+    public:
+        zoneMap_t(std::size_t numCols)
+            : m_cols(numCols) {}
+
+        auto update(const row_t &row, const row_t *previous, const std::vector<compareFunc_f> &compareFuncs) -> void
+        {
+            for (std::size_t i = 0; i < m_cols.size(); ++i)
+                m_cols[i].update(row[i], previous == nullptr ? nullptr : &(*previous)[i], compareFuncs[i]);
+
+            ++m_numRows;
+        }
+
+        auto numRows() const noexcept -> std::size_t { return m_numRows; }
+        auto getColumn(colIndex_t colIndex) const -> const columnZone_t & { return m_cols[colIndex.get()]; }
+
+    private:
+        std::size_t m_numRows = 0;
+        std::vector<columnZone_t> m_cols; // Parallel to the table definition
+    };
+
+    /**
+     * @brief Zone maps for each consecutive block of zoneRows rows of a table, built the first time they're needed
+     *
+     *        Appending rows leaves them stale rather than paying for the statistics on every append, the rows
+     *        that aren't covered yet get folded in by the next get(). Reordering the rows throws everything away
+     *
+     *  NOTE: get() is const and may be called by several readers at once, the first one does the catching up
+     */
+    class lazyZoneMaps_t
+    {
+    public:
+        explicit lazyZoneMaps_t(std::size_t zoneRows)
+            : m_zoneRows(zoneRows) {}
+
+        lazyZoneMaps_t(const lazyZoneMaps_t &other)
+            : m_zoneRows(other.m_zoneRows)
+        {
+            std::lock_guard lock(other.m_mutex);
+            m_zones = other.m_zones;
+            m_coveredRows = other.m_coveredRows;
+        }
+
+        lazyZoneMaps_t(lazyZoneMaps_t &&other) noexcept
+            : m_zoneRows(other.m_zoneRows),
+              m_zones(std::move(other.m_zones)),
+              m_coveredRows(std::exchange(other.m_coveredRows, 0)) {}
+
+        auto operator=(const lazyZoneMaps_t &other) -> lazyZoneMaps_t &
+        {
+            if (this != &other)
+            {
+                std::scoped_lock lock(m_mutex, other.m_mutex);
+                m_zoneRows = other.m_zoneRows;
+                m_zones = other.m_zones;
+                m_coveredRows = other.m_coveredRows;
+            }
+
+            return *this;
+        }
+
+        auto operator=(lazyZoneMaps_t &&other) noexcept -> lazyZoneMaps_t &
+        {
+            m_zoneRows = other.m_zoneRows;
+            m_zones = std::move(other.m_zones);
+            m_coveredRows = std::exchange(other.m_coveredRows, 0);
+            return *this;
+        }
+
+        auto zoneRows() const noexcept -> std::size_t { return m_zoneRows; }
+
+        /**
+         * @brief Would get() have nothing to catch up on
+         */
+        auto isUpToDate(std::size_t numRows) const -> bool
+        {
+            std::lock_guard lock(m_mutex);
+            return m_coveredRows == numRows;
+        }
+
+        /**
+         * @brief The rows were reordered, none of the statistics hold anymore
+         */
+        auto invalidate() noexcept -> void
+        {
+            m_zones.clear();
+            m_coveredRows = 0;
+        }
+
+        /**
+         * @brief Zone maps covering every row, catching up on whatever was appended since the last call
+         *
+         * @param rows         Every row of the table, the ones already covered must not have changed
+         * @param compareFuncs Parallel to the table definition
+         */
+        auto get(const rows_t &rows, const std::vector<compareFunc_f> &compareFuncs) const -> const std::vector<zoneMap_t> &
+        {
+            std::lock_guard lock(m_mutex);
+            for (; m_coveredRows < rows.size(); ++m_coveredRows)
+            {
+                const auto isFirstInZone = m_coveredRows % m_zoneRows == 0;
+                if (isFirstInZone)
+                    m_zones.emplace_back(compareFuncs.size());
+
+                m_zones.back().update(rows[m_coveredRows], isFirstInZone ? nullptr : &rows[m_coveredRows - 1], compareFuncs);
+            }
+
+            return m_zones;
+        }
+
+    private:
+        std::size_t m_zoneRows; // Rows covered by each zone map, only the last one can be partially full
+
+        mutable std::mutex m_mutex;             // Guards the catching up in get()
+        mutable std::vector<zoneMap_t> m_zones; // Statistics for rows [i * m_zoneRows, (i + 1) * m_zoneRows)
+        mutable std::size_t m_coveredRows = 0;  // Rows already folded into m_zones
+    };
+}
+
+#endif // INCLUDE_ZONE_MAP_H